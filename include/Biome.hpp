@@ -0,0 +1,64 @@
+#ifndef BIOME_H
+#define BIOME_H
+
+#include "Chunk.hpp"
+#include "FastNoiseLite.h"
+
+namespace BiomeType {
+    constexpr unsigned char PLAINS    = 0;
+    constexpr unsigned char FOREST    = 1;
+    constexpr unsigned char DESERT    = 2;
+    constexpr unsigned char BADLANDS  = 3;
+    constexpr unsigned char TAIGA     = 4;
+    constexpr unsigned char SNOWY     = 5;
+    constexpr unsigned char MOUNTAINS = 6;
+    constexpr unsigned char COUNT     = 7;
+}
+
+namespace TreeType {
+    constexpr unsigned char NONE   = 0;
+    constexpr unsigned char OAK    = 1;
+    constexpr unsigned char SPRUCE = 2;
+}
+
+// Parametri di altezza, regole di superficie e decorazione per bioma
+struct BiomeParams {
+    float base;            // Altezza minima del terreno
+    float amplitude;       // Escursione data dal rumore di altezza
+    unsigned char top;     // Blocco di superficie
+    unsigned char filler;  // Blocchi sotto la superficie
+    int fillerDepth;       // Spessore dello strato filler
+    float treeChance;      // Probabilità di un albero per colonna
+    unsigned char tree;    // Tipo di albero (TreeType)
+};
+
+const BiomeParams& getBiomeParams(unsigned char biome);
+
+// Risultato del campionamento per una singola colonna (x,z) del chunk
+struct ColumnBiome {
+    float base;
+    float amplitude;
+    unsigned char biome; // Bioma dominante (sceglie le regole di superficie)
+};
+
+// Mappa dei biomi campionata a bassa risoluzione (una cella ogni BIOME_CELL colonne).
+// I parametri di altezza vengono interpolati bilinearmente tra i 4 angoli della cella,
+// il bioma di superficie viene scelto con un dithering pesato sugli stessi pesi.
+// Costo fisso per chunk: BIOME_SAMPLES_PER_CHUNK valutazioni di temperatura/umidità.
+class BiomeMap {
+public:
+    explicit BiomeMap(int seed = WorldConfig::WORLD_SEED);
+
+    // Bioma in un punto del mondo (campionamento diretto, senza blending)
+    unsigned char biomeAt(float worldX, float worldZ) const;
+
+    // Riempie le colonne di un chunk con i parametri già interpolati
+    void sampleChunk(int chunkX, int chunkZ, ColumnBiome out[Chunk::SIZE][Chunk::SIZE]) const;
+
+private:
+    int seed;
+    FastNoiseLite temperature;
+    FastNoiseLite humidity;
+};
+
+#endif
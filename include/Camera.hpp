@@ -62,17 +62,17 @@ public:
 
     [[nodiscard]] glm::mat4 GetViewMatrix() const;
 
-    void ProcessKeyboard(Camera_Movement direction, float deltaTime, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks);
+    void ProcessKeyboard(Camera_Movement direction, float deltaTime, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks);
     void ProcessMouseMovement(float xoffset, float yoffset, bool constrainPitch = true);
     void ProcessJump();
-    void UpdatePhysics(float deltaTime, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks);
+    void UpdatePhysics(float deltaTime, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks);
 
     // Aggiorna il frustum (da chiamare ogni frame prima del render)
     void updateFrustum(float aspect, float fov, float nearPlane, float farPlane);
 
 private:
     void updateCameraVectors();
-    bool checkCollision(glm::vec3 nextPos, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks) const;
+    bool checkCollision(glm::vec3 nextPos, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks) const;
 };
 
 #endif
\ No newline at end of file
@@ -3,8 +3,14 @@
 
 #include <vector>
 #include <string>
-#include <OpenGL/gl3.h>
+#include <bitset>
+#include <atomic>
+#include <cstdint>
+#include "GLHeaders.hpp"
 #include <glm/glm.hpp>
+#include "ChunkMeshArena.hpp"
+
+struct ChunkJob;
 
 // --- COSTANTI GLOBALI ---
 namespace BlockType {
@@ -13,7 +19,23 @@ namespace BlockType {
     constexpr unsigned char DIRT     = 2;
     constexpr unsigned char STONE    = 3;
     constexpr unsigned char BEDROCK  = 4;
-    constexpr unsigned char COUNT    = 5; // Numero totale di tipi
+    constexpr unsigned char SAND       = 5;
+    constexpr unsigned char SANDSTONE  = 6;
+    constexpr unsigned char SNOW       = 7;
+    constexpr unsigned char RED_SAND   = 8;
+    constexpr unsigned char TERRACOTTA = 9;
+    constexpr unsigned char GRAVEL     = 10;
+    constexpr unsigned char PODZOL     = 11;
+    constexpr unsigned char OAK_LOG       = 12;
+    constexpr unsigned char OAK_LEAVES    = 13;
+    constexpr unsigned char SPRUCE_LOG    = 14;
+    constexpr unsigned char SPRUCE_LEAVES = 15;
+    constexpr unsigned char COUNT      = 16; // Numero totale di tipi
+}
+
+// Blocchi che non nascondono le facce dei vicini (foglie con alpha cutout)
+inline bool isTransparent(unsigned char block) {
+    return block == BlockType::AIR || block == BlockType::OAK_LEAVES || block == BlockType::SPRUCE_LEAVES;
 }
 
 namespace TextureLayer {
@@ -22,17 +44,39 @@ namespace TextureLayer {
     constexpr float DIRT       = 2.0f;
     constexpr float STONE      = 3.0f;
     constexpr float BEDROCK    = 4.0f;
+    constexpr float SAND        = 5.0f;
+    constexpr float SANDSTONE   = 6.0f;
+    constexpr float SNOW        = 7.0f;
+    constexpr float RED_SAND    = 8.0f;
+    constexpr float TERRACOTTA  = 9.0f;
+    constexpr float GRAVEL      = 10.0f;
+    constexpr float PODZOL_TOP  = 11.0f;
+    constexpr float PODZOL_SIDE = 12.0f;
+    constexpr float OAK_LOG_SIDE    = 13.0f;
+    constexpr float OAK_LOG_TOP     = 14.0f;
+    constexpr float OAK_LEAVES      = 15.0f;
+    constexpr float SPRUCE_LOG_SIDE = 16.0f;
+    constexpr float SPRUCE_LOG_TOP  = 17.0f;
+    constexpr float SPRUCE_LEAVES   = 18.0f;
 }
 
 namespace WorldConfig {
     constexpr int RENDER_DISTANCE      = 8;
+    constexpr int GENERATION_DISTANCE  = RENDER_DISTANCE + 1; // Un anello in più: i vicini dei chunk da meshare
     constexpr int UNLOAD_DISTANCE      = 10;
+    // Livelli di dettaglio delle mesh: 0 = blocchi pieni, n = celle di 2^n blocchi per lato (fino a 8x8x8)
+    constexpr int LOD_LEVELS           = 4;
+    // Distanza (in chunk, Chebyshev) da cui inizia ogni livello: anelli intorno al giocatore
+    constexpr int LOD_RING_START[LOD_LEVELS] = { 0, 4, 6, 8 };
     constexpr int INITIAL_LOAD_RADIUS  = 2;
-    constexpr int UPLOADS_PER_FRAME    = 16;
+    constexpr int IO_THREADS           = 2; // Letture da disco: separate dal pool di calcolo
+    constexpr double MAIN_THREAD_BUDGET_MS = 2.0; // Lavoro sul thread principale per frame (~12% di 16.6 ms)
     constexpr float INTERACTION_RANGE  = 5.0f;
+    constexpr int WORLD_SEED           = 1337;
     constexpr float NOISE_FREQUENCY    = 0.01f;
-    constexpr float TERRAIN_BASE       = 30.0f;
-    constexpr float TERRAIN_AMPLITUDE  = 20.0f;
+    constexpr float BIOME_FREQUENCY    = 0.002f;
+    constexpr int BIOME_CELL           = 4;  // Risoluzione della mappa biomi (colonne per cella)
+    constexpr int BIOME_SAMPLES_PER_CHUNK = (16 / BIOME_CELL + 1) * (16 / BIOME_CELL + 1);
 }
 
 namespace PlayerConfig {
@@ -52,6 +96,20 @@ inline long long chunkHash(int x, int z) {
 
 class Chunk;
 
+// Facce di una sezione 16x16x16 per il grafo di connettività (opposta = faccia ^ 1)
+namespace SectionFace {
+    constexpr int NEG_X = 0, POS_X = 1;
+    constexpr int NEG_Y = 2, POS_Y = 3;
+    constexpr int NEG_Z = 4, POS_Z = 5;
+    constexpr int COUNT = 6;
+}
+
+// Run verticale di blocchi uguali in una colonna (dal basso verso l'alto)
+struct BlockRun {
+    unsigned char block;
+    unsigned char length; // 1..HEIGHT
+};
+
 // Puntatori ai chunk adiacenti per il cross-boundary face culling
 struct ChunkNeighbors {
     const Chunk* left   = nullptr; // x-1
@@ -64,42 +122,111 @@ class Chunk {
 public:
     static const int SIZE = 16;
     static const int HEIGHT = 128;
-
-    unsigned char blocks[SIZE][HEIGHT][SIZE]{};
+    static const int SECTION_SIZE = 16;
+    static const int SECTIONS = HEIGHT / SECTION_SIZE;
+    static const unsigned char MIXED_SECTION = 0xFF;
+    static const int OCCLUDER_CELL = 4;                        // Colonne per lato di una cella occluder
+    static const int OCCLUDER_CELLS = SIZE / OCCLUDER_CELL;    // Celle per lato
+    // Connettività di una sezione: bit (a * 6 + b) acceso se le facce a e b sono collegate da spazio non opaco
+    static constexpr uint64_t ALL_FACES_CONNECTED = (uint64_t(1) << (SectionFace::COUNT * SectionFace::COUNT)) - 1;
+    static bool facesConnected(uint64_t connectivity, int a, int b) {
+        return (connectivity >> (a * SectionFace::COUNT + b)) & 1;
+    }
+
+    // Layout y-contiguo: blocks[x][z] è la colonna intera, riempibile con memset a run.
+    // Accedere tramite getBlock/setBlock per mantenere coerenti i riepiloghi sotto.
+    unsigned char blocks[SIZE][SIZE][HEIGHT]{};
+
+    // Riepiloghi derivati dai run di colonna
+    unsigned char heightMap[SIZE][SIZE]{};   // y del blocco non-aria più alto + 1 (0 = colonna vuota)
+    unsigned char sectionBlock[SECTIONS]{};  // Blocco uniforme della sezione 16x16x16, o MIXED_SECTION
 
     int chunkX, chunkZ;
     bool isUploaded = false;
     bool needsReupload = false;
+    bool isGenerated = false;  // Terreno e decorazioni pronti (solo thread principale)
+    bool isMeshQueued = false; // Mesh iniziale già lanciata (solo thread principale)
+    // Al più un job di mesh per chunk (legge blocks e scrive vertices): le richieste che arrivano mentre
+    // è già in volo lasciano solo la classe più urgente in remeshKind, rilanciata una volta al termine
+    ChunkJob* meshJob = nullptr; // Job accodato o in volo (solo thread principale)
+    int remeshKind = -1;         // ChunkJobKind del rilancio in attesa, -1 = nessuno
+    int lod = 0;               // Livello delle prossime mesh: cambiato dal thread principale solo senza job in corso
     bool modified = false; // True se il chunk è stato modificato dal giocatore
-    unsigned int indexCount = 0;
+    // Chiome dei vicini già ricevute: bit (dx + 1) * 3 + (dz + 1) per il vicino (dx, dz). Salvato con il chunk,
+    // così un vicino ricaricato non riscrive le foglie che il giocatore ha tolto
+    static constexpr uint16_t ALL_SPILL_RECEIVED = 0x1FF;
+    uint16_t spillReceived = 0;
+    std::atomic<bool> cancelled{false}; // Scaricato: i job in volo lo controllano e terminano subito
+
+    // Dati per l'occlusion culling della mesh caricata (copiati in upload, solo thread principale):
+    // per cella 4x4 colonne l'altezza fino a cui è tutto pieno (blocchi opachi da y=0), e l'estensione
+    // verticale dei blocchi che hanno facce
+    unsigned char occluderHeights[OCCLUDER_CELLS][OCCLUDER_CELLS]{};
+    int meshMinY = 0, meshMaxY = 0;
+    // Connettività delle sezioni per il cave culling. Finché il chunk non ha una mesh tutto è collegato
+    uint64_t sectionConnectivity[SECTIONS];
+    // Mesh divisa per direzione di faccia (ordine di SectionFace): bucket f = quad [start[f], start[f+1])
+    unsigned int faceBucketStart[SectionFace::COUNT + 1]{};
 
     Chunk(int chunkX, int chunkZ);
     ~Chunk();
 
-    void generate();
-    void generateTerrain();
-    void upload();
-    void reupload();
-    void render() const;
+    unsigned char getBlock(int x, int y, int z) const { return blocks[x][z][y]; }
+    void setBlock(int x, int y, int z, unsigned char block);
 
-    void rebuild(const ChunkNeighbors& neighbors = {});
+    void generate();
+    void generateTerrain(int seed = WorldConfig::WORLD_SEED);
+    // La mesh vive in un intervallo dell'arena condivisa (il chunk lo restituisce alla distruzione)
+    void upload(ChunkMeshArena& arena);
+    void reupload(ChunkMeshArena& arena);
+    // Disegna solo i bucket di facce che possono essere rivolti verso `eye`
+    void render(const glm::vec3& eye) const;
+    // Intervalli di quad (primo, numero) di quei bucket, al più 3: per il percorso multi-draw indirect
+    int visibleFaceRanges(const glm::vec3& eye, unsigned int firstQuad[3], unsigned int quadCount[3]) const;
+    const MeshAllocation& meshAllocation() const { return mesh; }
+
+    void rebuild(ChunkMeshArena& arena, const ChunkNeighbors& neighbors = {});
     void rebuildMeshOnly(const ChunkNeighbors& neighbors = {});
 
     // Persistenza mondo
     bool saveToFile(const std::string& worldDir) const;
     bool loadFromFile(const std::string& worldDir);
+    static std::string filePath(const std::string& worldDir, int cx, int cz);
 
     glm::vec3 getMin() const { return glm::vec3(chunkX * SIZE, 0, chunkZ * SIZE); }
     glm::vec3 getMax() const { return glm::vec3((chunkX + 1) * SIZE, HEIGHT, (chunkZ + 1) * SIZE); }
 
 private:
-    unsigned int VAO{}, VBO{}, EBO{};
+    ChunkMeshArena* arena = nullptr;
+    MeshAllocation mesh;
+
+    void releaseMesh();
+
+    // Run per colonna prodotti da generazione/caricamento: columnRuns[runOffset[c] .. runOffset[c+1]).
+    // Il salvataggio li riusa direttamente per le colonne non modificate da allora.
+    std::vector<BlockRun> columnRuns;
+    unsigned short runOffset[SIZE * SIZE + 1]{};
+    std::bitset<SIZE * SIZE> dirtyColumns;
+
+    void applyColumnRuns(bool fillBlocks);
+    void encodeColumn(int x, int z, std::vector<BlockRun>& out) const;
 
     std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+    // Calcolati da generateMesh (anche su un worker) insieme ai vertici, pubblicati da upload
+    unsigned char pendingOccluderHeights[OCCLUDER_CELLS][OCCLUDER_CELLS]{};
+    int pendingMinY = 0, pendingMaxY = 0;
+    uint64_t pendingConnectivity[SECTIONS];
+    unsigned int pendingFaceBucketStart[SectionFace::COUNT + 1]{};
+    // Sezioni modificate dall'ultimo calcolo della connettività (setBlock dal thread principale, mesh sui worker)
+    std::atomic<unsigned char> dirtySections{0xFF};
+    static_assert(SECTIONS <= 8, "dirtySections: un bit per sezione");
+
+    uint64_t computeSectionConnectivity(int section) const;
 
     void generateMesh(const ChunkNeighbors& neighbors = {});
-    void addFace(int x, int y, int z, std::string faceType, unsigned char blockID);
+    void generateLodFaces(const ChunkNeighbors& neighbors, int level);
+    // Quad di lato `size` blocchi con origine (x, y, z): 1 per i blocchi, 2^lod per le celle delle mesh ridotte
+    void addFace(int x, int y, int z, std::string faceType, unsigned char blockID, int size = 1);
 };
 
 #endif
\ No newline at end of file
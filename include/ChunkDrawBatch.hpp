@@ -0,0 +1,47 @@
+#ifndef CHUNKDRAWBATCH_H
+#define CHUNKDRAWBATCH_H
+
+#include <vector>
+#include "ChunkMeshArena.hpp"
+
+// Disegno di tutti i chunk visibili con un solo glMultiDrawElementsIndirect (contesti GL 4.3+, es. Mesa su Linux).
+// Un comando per chunk nel buffer indiretto; l'offset del chunk arriva come attributo per istanza
+// scelto da baseInstance, al posto della uniform `chunkOffset` del percorso per chunk.
+// Su GL 4.1 (macOS) init() fallisce e il chiamante resta sul percorso con un draw per chunk.
+class ChunkDrawBatch {
+public:
+    ~ChunkDrawBatch();
+
+    // Richiede il contesto corrente. false se la versione è < 4.3 o la funzione non si carica.
+    bool init(ChunkMeshArena& arena);
+    bool isAvailable() const { return multiDrawElementsIndirect != nullptr; }
+
+    void clear();
+    // Un comando per intervallo di quad (bucket di facce visibili), tutti con l'offset dello stesso chunk
+    void add(const MeshAllocation& mesh, const unsigned int* firstQuads, const unsigned int* quadCounts, int ranges,
+             int chunkX, int chunkZ);
+    // Carica comandi e offset e disegna tutto (VAO dell'arena già legato)
+    void submit();
+
+    size_t size() const { return commands.size(); }
+
+private:
+    // Layout fissato dalla specifica di glMultiDrawElementsIndirect
+    struct DrawCommand {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int firstIndex;
+        int baseVertex;
+        unsigned int baseInstance;
+    };
+
+    using MultiDrawElementsIndirectFn = void (*)(unsigned int mode, unsigned int type, const void* indirect,
+                                                 int drawCount, int stride);
+    MultiDrawElementsIndirectFn multiDrawElementsIndirect = nullptr;
+
+    std::vector<DrawCommand> commands;
+    std::vector<float> offsets; // Due float (x, z in blocchi) per chunk, indicizzati da baseInstance
+    unsigned int commandBuffer = 0, offsetBuffer = 0;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef CHUNKDRAWORDER_H
+#define CHUNKDRAWORDER_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include "Chunk.hpp"
+
+// Ordine di disegno dei chunk, dal più vicino alla camera al più lontano: i chunk davanti riempiono
+// prima il depth buffer e i frammenti coperti dietro vengono scartati dal test di profondità (early-Z).
+// L'ordine si ricalcola solo quando la camera cambia chunk o l'insieme dei chunk cambia (invalidate()),
+// altrimenti si riusa quello del frame prima. Il culling per frustum resta per frame, sulla lista già ordinata.
+// I puntatori valgono finché i chunk restano nella mappa: chi inserisce o rimuove chunk chiama invalidate().
+class ChunkDrawOrder {
+public:
+    void invalidate() { dirty = true; }
+
+    // Senza ordinamento la lista segue l'ordine della mappa (per confrontare i frammenti prima/dopo)
+    void setSorted(bool enabled) {
+        if (enabled != sorted) dirty = true;
+        sorted = enabled;
+    }
+    bool isSorted() const { return sorted; }
+
+    const std::vector<Chunk*>& update(const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks,
+                                      int cameraChunkX, int cameraChunkZ) {
+        if (!dirty && cameraChunkX == lastChunkX && cameraChunkZ == lastChunkZ) return order;
+        dirty = false;
+        lastChunkX = cameraChunkX;
+        lastChunkZ = cameraChunkZ;
+
+        keyed.clear();
+        for (const auto& pair : chunks) {
+            int dx = pair.second->chunkX - cameraChunkX;
+            int dz = pair.second->chunkZ - cameraChunkZ;
+            keyed.push_back({ dx * dx + dz * dz, pair.second.get() });
+        }
+        if (sorted)
+            std::sort(keyed.begin(), keyed.end(), [](const Entry& a, const Entry& b) { return a.distSq < b.distSq; });
+
+        order.clear();
+        for (const Entry& entry : keyed) order.push_back(entry.chunk);
+        return order;
+    }
+
+private:
+    struct Entry { int distSq; Chunk* chunk; };
+    std::vector<Entry> keyed;
+    std::vector<Chunk*> order;
+    int lastChunkX = 0, lastChunkZ = 0;
+    bool dirty = true;
+    bool sorted = true;
+};
+
+#endif
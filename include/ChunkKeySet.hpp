@@ -0,0 +1,88 @@
+#ifndef CHUNKKEYSET_H
+#define CHUNKKEYSET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Insieme di chiavi chunkHash a indirizzamento aperto (sondaggio lineare, cancellazione con spostamento
+// all'indietro, niente lapidi). Gli slot sono preallocati: insert/erase non toccano l'allocatore globale,
+// a differenza dei nodi di std::unordered_set. Solo se il carico supera metà la tabella raddoppia.
+// Non thread-safe: usato dal thread principale.
+class ChunkKeySet {
+public:
+    // capacity: numero di slot iniziale, arrotondato a una potenza di due
+    explicit ChunkKeySet(size_t capacity = 1024) {
+        size_t slots = 16;
+        while (slots < capacity) slots *= 2;
+        resize(slots);
+    }
+
+    // Restituisce false se la chiave era già presente
+    bool insert(long long key) {
+        if ((count + 1) * 2 > keys.size()) resize(keys.size() * 2);
+        size_t i = home(key);
+        while (used[i]) {
+            if (keys[i] == key) return false;
+            i = (i + 1) & mask;
+        }
+        keys[i] = key;
+        used[i] = 1;
+        count++;
+        return true;
+    }
+
+    // Restituisce false se la chiave non era presente
+    bool erase(long long key) {
+        size_t i = home(key);
+        while (used[i] && keys[i] != key) i = (i + 1) & mask;
+        if (!used[i]) return false;
+
+        // Riporta indietro le chiavi successive della stessa catena, così la ricerca resta corretta senza lapidi
+        used[i] = 0;
+        count--;
+        for (size_t j = (i + 1) & mask; used[j]; j = (j + 1) & mask) {
+            size_t k = home(keys[j]);
+            bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (stays) continue;
+            keys[i] = keys[j];
+            used[i] = 1;
+            used[j] = 0;
+            i = j;
+        }
+        return true;
+    }
+
+    bool contains(long long key) const {
+        for (size_t i = home(key); used[i]; i = (i + 1) & mask)
+            if (keys[i] == key) return true;
+        return false;
+    }
+
+    size_t size() const { return count; }
+
+private:
+    std::vector<long long> keys;
+    std::vector<unsigned char> used; // Ogni valore a 64 bit è una chiave valida: niente sentinella
+    size_t mask = 0;
+    size_t count = 0;
+
+    size_t home(long long key) const {
+        // Fibonacci hashing: x e z stanno nelle due metà della chiave, il prodotto le mescola nei bit alti
+        uint64_t h = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    void resize(size_t slots) {
+        std::vector<long long> oldKeys = std::move(keys);
+        std::vector<unsigned char> oldUsed = std::move(used);
+        keys.assign(slots, 0);
+        used.assign(slots, 0);
+        mask = slots - 1;
+        count = 0;
+        for (size_t i = 0; i < oldKeys.size(); i++)
+            if (oldUsed[i]) insert(oldKeys[i]);
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef CHUNKMESHARENA_H
+#define CHUNKMESHARENA_H
+
+#include <vector>
+#include <cstddef>
+
+// Sotto-allocatore di intervalli [offset, offset+count) dentro un buffer più grande.
+// Lista dei blocchi liberi ordinata per offset, first-fit, fusione dei vicini al rilascio.
+class RangeAllocator {
+public:
+    explicit RangeAllocator(size_t capacity = 0);
+
+    // false se nessun blocco libero è abbastanza grande (il chiamante fa grow e riprova)
+    bool allocate(size_t count, size_t& offset);
+    void free(size_t offset, size_t count);
+    // Estende la capacità: lo spazio nuovo si unisce all'ultimo blocco libero se adiacente
+    void grow(size_t newCapacity);
+
+    size_t capacity() const { return total; }
+    size_t used() const { return usedCount; }
+    size_t freeBlocks() const { return freeList.size(); }
+    size_t largestFree() const;
+
+private:
+    struct Range { size_t offset, count; };
+    std::vector<Range> freeList;
+    size_t total = 0;
+    size_t usedCount = 0;
+};
+
+// Posizione della mesh di un chunk dentro l'arena (in vertici, non in byte)
+struct MeshAllocation {
+    unsigned int vertexOffset = 0, vertexCount = 0; // vertexCount: vertici riservati (arrotondati)
+    unsigned int indexCount = 0;                    // 6 per quad, letti dal buffer di indici condiviso
+};
+
+// Un solo VAO/VBO/EBO per tutte le mesh dei chunk. Ogni chunk possiede un intervallo di vertici;
+// si disegna con base vertex (glMultiDrawElementsBaseVertex, un intervallo per bucket di facce)
+// senza cambiare VAO tra un chunk e l'altro.
+// Le mesh sono solo quad (4 vertici, due triangoli 0,1,2 / 0,2,3): gli indici sono sempre gli stessi,
+// quindi un unico EBO precalcolato serve tutti i chunk e il chunk carica solo i vertici.
+// Quando non c'è spazio il buffer dei vertici raddoppia (copia lato GPU): le allocazioni esistenti restano valide.
+// Solo thread principale (contesto GL).
+class ChunkMeshArena {
+public:
+    static constexpr int VERTEX_FLOATS = 7; // Posizione, U/V/layer, luminosità (vedi Chunk::addFace)
+
+    // Capacità iniziali in vertici e in quad per il buffer di indici; i buffer GL si creano al primo upload (serve il contesto)
+    ChunkMeshArena(size_t vertexCapacity, size_t quadCapacity);
+    ~ChunkMeshArena();
+
+    ChunkMeshArena(const ChunkMeshArena&) = delete;
+    ChunkMeshArena& operator=(const ChunkMeshArena&) = delete;
+
+    // Copia i vertici (quad consecutivi) nell'arena. false per mesh vuota.
+    // Se `out` ha già un intervallo e la mesh ci sta, la riscrive lì (glBufferSubData, nessuna allocazione);
+    // altrimenti lo rilascia e ne prende uno più grande del necessario, così le modifiche successive ci stanno.
+    bool upload(const std::vector<float>& vertices, MeshAllocation& out);
+    void release(MeshAllocation& allocation);
+
+    // Attributo per istanza (location 3, vec2 offset del chunk) letto da `buffer`: serve al multi-draw indirect,
+    // dove ogni comando sceglie il suo offset con baseInstance. Crea i buffer se non esistono ancora.
+    void attachInstanceOffsets(unsigned int buffer);
+
+    // Da chiamare una volta prima di disegnare i chunk
+    void bind() const;
+    // Uno o più intervalli di quad della stessa mesh in una sola chiamata (glMultiDrawElementsBaseVertex)
+    void draw(const MeshAllocation& allocation, const unsigned int* firstQuads, const unsigned int* quadCounts, int ranges) const;
+
+    struct Stats {
+        size_t vertexCapacity, vertexUsed;
+        size_t quadCapacity;   // Quad coperti dal buffer di indici condiviso (la mesh più grande vista)
+        size_t freeBlocks;     // Blocchi liberi: tanti = arena frammentata
+        float fragmentation;   // 1 - più grande blocco libero / spazio libero totale
+        size_t growths;        // Raddoppi dall'avvio
+        size_t inPlaceUpdates; // Reupload riscritti nel proprio intervallo
+        size_t reallocations;  // Reupload che hanno dovuto cambiare intervallo
+    };
+    Stats stats() const;
+
+private:
+    // Arrotondamento delle allocazioni: meno blocchi minuscoli tra una mesh e l'altra
+    static constexpr size_t GRANULARITY = 64;
+    // Margine di un intervallo riallocato (+50%): crescita geometrica per i chunk modificati spesso
+    static constexpr size_t GROWTH_NUM = 3, GROWTH_DEN = 2;
+
+    RangeAllocator vertexRanges;
+    size_t quadCapacity;
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int instanceBuffer = 0;
+    size_t growths = 0;
+    size_t inPlaceUpdates = 0;
+    size_t reallocations = 0;
+
+    void createBuffers();
+    void setupVertexAttributes() const;
+    void growVertices(size_t minCapacity);
+    size_t allocateVertices(size_t slots); // Offset di un intervallo libero, cresce se serve
+    void fillQuadIndices(); // Riempie l'EBO con il pattern per quadCapacity quad
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CHUNKSCHEDULER_H
+#define CHUNKSCHEDULER_H
+
+#include <vector>
+#include <memory>
+#include <coroutine>
+#include "Camera.hpp"
+#include "Chunk.hpp"
+
+// Classe del job: a parità di altro vince sempre la classe più bassa
+enum class ChunkJobKind {
+    EDIT_REMESH = 0, // Remesh dopo una modifica del giocatore: sempre per primo
+    MESH        = 1, // Mesh iniziale di un chunk appena generato (vicini pronti)
+    REMESH      = 2, // Remesh di sfondo (es. decorazioni arrivate da un vicino, cambio di anello LOD)
+    GENERATE    = 3  // Caricamento/generazione di un chunk nuovo
+};
+
+// Record di un job: riciclato dallo scheduler, usato dalla coroutine del job per tutta la sua durata.
+// I vettori mantengono la capacità tra un uso e l'altro: a regime nessuna allocazione per job.
+struct ChunkJob {
+    ChunkJobKind kind = ChunkJobKind::GENERATE;
+    long long key = 0;
+    int chunkX = 0, chunkZ = 0;
+    std::vector<std::shared_ptr<Chunk>> chunks;    // Chunk generati/rimeshati dal job
+    std::vector<ChunkNeighbors> meshNeighbors;     // Vicini di ogni chunk in `chunks` (remesh)
+    std::vector<std::shared_ptr<Chunk>> neighbors; // Solo letti dal job: tenuti vivi fino al completamento
+    std::coroutine_handle<> waiter;                // Coroutine in attesa dello slot
+    bool dropped = false;                          // Scartato prima dell'invio (chunk scaricati)
+    bool running = false;                          // Inviato al pool: i worker leggono i chunk e i loro bordi
+    float priority = 0.0f;       // Più basso = prima
+};
+
+// Coda a priorità dei job sui chunk, tenuta sul thread principale.
+// Il pool riceve solo pochi job alla volta (slot liberi), così quando la camera si muove
+// le priorità dei job non ancora inviati vengono ricalcolate e l'area visibile si riempie prima.
+// Priorità: classe del job, poi dentro/fuori dal frustum, poi distanza dal giocatore.
+class ChunkScheduler {
+public:
+    // Record libero (dal pool interno) e sua restituzione a job completato o scartato
+    ChunkJob* acquire();
+    void release(ChunkJob* job);
+
+    void enqueue(ChunkJob* job);
+
+    // Porta un job ancora in coda alla classe `kind`, se più urgente della sua.
+    // Restituisce false se il job è già stato inviato al pool (non più in coda).
+    bool promote(ChunkJob* job, ChunkJobKind kind);
+
+    // co_await slot(job): accoda il job e sospende la coroutine finché lo scheduler non le dà uno slot.
+    // Restituisce false se il job è stato scartato (chunk scaricati) invece che inviato.
+    auto slot(ChunkJob* job) {
+        struct Awaiter {
+            ChunkScheduler& scheduler;
+            ChunkJob* job;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                job->waiter = handle;
+                scheduler.enqueue(job);
+            }
+            bool await_resume() const noexcept { return !job->dropped; }
+        };
+        return Awaiter{*this, job};
+    }
+
+    // Ricalcola le priorità se la camera ha cambiato chunk o direzione di vista
+    void updateCamera(const Camera& camera);
+
+    // Estrae i job a priorità più alta: fino a `slots` job di sfondo, più tutti gli EDIT_REMESH.
+    // Il vettore restituito è interno e resta valido fino alla chiamata successiva.
+    // Il chiamante riprende job->waiter di ciascuno.
+    const std::vector<ChunkJob*>& takeReady(size_t slots);
+
+    // Toglie i job non ancora inviati i cui chunk sono stati tutti scaricati (marcati dropped).
+    // Il chiamante riprende job->waiter di ciascuno, che vede lo slot negato e fa pulizia.
+    const std::vector<ChunkJob*>& takeCancelled();
+
+    size_t size() const { return jobs.size(); }
+
+private:
+    std::vector<ChunkJob*> jobs; // Min-heap su priority
+    std::vector<ChunkJob*> ready;
+    std::vector<ChunkJob*> cancelled;
+    std::vector<std::unique_ptr<ChunkJob>> records; // Tutti i record mai creati
+    std::vector<ChunkJob*> freeRecords;
+    glm::vec3 cameraFront{0.0f, 0.0f, -1.0f};
+    Frustum frustum{};
+    int cameraChunkX = 0, cameraChunkZ = 0;
+    bool hasCamera = false;
+
+    float computePriority(const ChunkJob& job) const;
+    void rebuildHeap();
+};
+
+#endif
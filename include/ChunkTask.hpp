@@ -0,0 +1,94 @@
+#ifndef CHUNKTASK_H
+#define CHUNKTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include <utility>
+#include "ThreadPool.hpp"
+#include "CompletionQueue.hpp"
+
+// Pool dei frame delle coroutine, per dimensione (pochi tipi di coroutine = pochi bucket).
+// Solo thread principale: le coroutine dei chunk partono e terminano sempre lì.
+class CoroutineFramePool {
+public:
+    static void* allocate(size_t size) {
+        std::vector<void*>& bucket = bucketFor(size);
+        if (bucket.empty()) return ::operator new(size);
+        void* frame = bucket.back();
+        bucket.pop_back();
+        return frame;
+    }
+
+    static void deallocate(void* frame, size_t size) {
+        bucketFor(size).push_back(frame);
+    }
+
+private:
+    static inline std::vector<std::pair<size_t, std::vector<void*>>> buckets;
+
+    static std::vector<void*>& bucketFor(size_t size) {
+        for (auto& bucket : buckets)
+            if (bucket.first == size) return bucket.second;
+        buckets.emplace_back(size, std::vector<void*>());
+        return buckets.back().second;
+    }
+};
+
+// Coroutine fire-and-forget per le fasi del ciclo di vita di un chunk.
+// Parte subito sul thread chiamante e libera il frame da sola al termine.
+// Regola: ogni coroutine deve terminare sul thread principale (ultimo co_await su resumeOnMainThread),
+// così il frame torna al pool e i riferimenti ai chunk (e le risorse GL) si rilasciano lì.
+struct ChunkTask {
+    struct promise_type {
+        ChunkTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return CoroutineFramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) { CoroutineFramePool::deallocate(frame, size); }
+    };
+};
+
+// co_await resumeOn(pool): la coroutine prosegue su un worker del pool
+inline auto resumeOn(ThreadPool& pool) {
+    struct Awaiter {
+        ThreadPool& pool;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            pool.post([handle]() { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{pool};
+}
+
+// co_await resumeOnMainThread(queue): la coroutine prosegue sul thread principale,
+// quando il drain della coda (a budget, nel frame) arriva al suo nodo.
+// L'awaiter vive nel frame durante la sospensione ed è lui stesso il nodo: nessuna allocazione.
+struct MainThreadResume : CompletionNode {
+    CompletionQueue& queue;
+    std::coroutine_handle<> handle;
+
+    explicit MainThreadResume(CompletionQueue& queue) : queue(queue) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        handle = h;
+        queue.push(this); // Dopo il push il frame può già essere ripreso: non toccare più this
+    }
+    void await_resume() const noexcept {}
+};
+
+inline MainThreadResume resumeOnMainThread(CompletionQueue& queue) {
+    return MainThreadResume(queue);
+}
+
+// Riprende la coroutine di un nodo estratto dalla coda (thread principale)
+inline void resumeCompleted(CompletionNode* node) {
+    static_cast<MainThreadResume*>(node)->handle.resume();
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef COMPLETIONQUEUE_H
+#define COMPLETIONQUEUE_H
+
+#include <atomic>
+
+// Nodo intrusivo: il record del job stesso viaggia nella coda, nessuna allocazione per push
+struct CompletionNode {
+    std::atomic<CompletionNode*> next{nullptr};
+};
+
+// Coda MPSC lock-free (Vyukov, intrusiva) per i job completati.
+// push: qualsiasi worker, wait-free (una exchange + una store).
+// pop: solo il thread principale; costo proporzionale ai job completati, non a quelli in volo.
+// Se un push è a metà pop restituisce nullptr: il nodo arriva al prossimo drain.
+class CompletionQueue {
+public:
+    CompletionQueue() : head(&stub), tail(&stub) {}
+
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    void push(CompletionNode* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        CompletionNode* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    CompletionNode* pop() {
+        CompletionNode* first = tail;
+        CompletionNode* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr) return nullptr;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        if (first != head.load(std::memory_order_acquire)) return nullptr;
+
+        // Ultimo nodo: rimette lo stub in coda per poterlo staccare
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next == nullptr) return nullptr;
+        tail = next;
+        return first;
+    }
+
+private:
+    std::atomic<CompletionNode*> head; // Lato produttori
+    CompletionNode* tail;              // Lato consumatore
+    CompletionNode stub;
+};
+
+#endif
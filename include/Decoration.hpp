@@ -0,0 +1,57 @@
+#ifndef DECORATION_H
+#define DECORATION_H
+
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include "Chunk.hpp"
+
+// Scrittura destinata a un chunk non ancora generato (coordinate locali al chunk di destinazione)
+struct PendingBlock {
+    unsigned char x, y, z;
+    unsigned char block;
+    unsigned char source; // Bit del chunk che l'ha emessa in Chunk::spillReceived del destinatario
+};
+
+// Code di scritture pendenti indicizzate per chunkHash.
+// Le strutture che escono dal proprio chunk (es. chiome degli alberi) vengono accodate qui
+// e applicate quando il chunk di destinazione viene generato o caricato.
+// Thread-safe: i worker accodano a blocchi (un lock per chunk di destinazione).
+class PendingBlockStore {
+public:
+    void push(long long key, const std::vector<PendingBlock>& writes);
+
+    // Rimuove e restituisce le scritture per un chunk (false se non ce ne sono)
+    bool take(long long key, std::vector<PendingBlock>& out);
+
+    // Chiavi che hanno ricevuto scritture dall'ultima chiamata
+    std::vector<long long> takeDirtyKeys();
+
+    // Chiavi con scritture ancora in coda
+    std::vector<long long> keys() const;
+
+    // Scarta le code dei chunk lontani: verranno riemesse dai vicini quando tornano in zona
+    void pruneOutside(int centerX, int centerZ, int radius);
+
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<long long, std::vector<PendingBlock>> queues;
+    std::vector<long long> dirtyKeys;
+};
+
+constexpr long long NO_TARGET = 0x7FFFFFFFFFFFFFFFLL;
+
+// Piazza gli alberi che nascono nel chunk.
+// writeSelf: scrive i blocchi interni al chunk (false per chunk caricati da disco, già decorati).
+// onlyTarget: se diverso da NO_TARGET, accoda solo le scritture verso quel chunk.
+void decorateChunk(Chunk& chunk, PendingBlockStore& pending, bool writeSelf, long long onlyTarget = NO_TARGET,
+                   int seed = WorldConfig::WORLD_SEED);
+
+// Applica le scritture pendenti del chunk. Restituisce true se almeno un blocco è cambiato.
+// Le chiome di un vicino arrivano una volta sola: quelle di vicini già in spillReceived vengono scartate
+// (es. chunk salvato che contiene già gli alberi, con foglie tolte dal giocatore), le altre lo aggiornano.
+bool applyPendingBlocks(Chunk& chunk, PendingBlockStore& pending);
+
+#endif
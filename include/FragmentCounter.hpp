@@ -0,0 +1,70 @@
+#ifndef FRAGMENTCOUNTER_H
+#define FRAGMENTCOUNTER_H
+
+#include "GLHeaders.hpp"
+#include <cstdint>
+
+// Assente dall'header di macOS (GL 4.6 / ARB_pipeline_statistics_query)
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS
+#define GL_FRAGMENT_SHADER_INVOCATIONS 0x82F4
+#endif
+
+// Conta i frammenti di un blocco di draw con una query GPU, senza fermare la pipeline:
+// anello di query, il risultato si legge qualche frame dopo, quando è disponibile.
+// Con GL 4.6 conta le invocazioni del fragment shader; su GL 4.1 (macOS) i campioni che passano
+// il test di profondità (GL_SAMPLES_PASSED), che con early-Z approssimano lo stesso lavoro.
+// Richiede il contesto corrente (init dopo la creazione della finestra).
+class FragmentCounter {
+public:
+    void init() {
+        int major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        countsInvocations = major > 4 || (major == 4 && minor >= 6);
+        target = countsInvocations ? GL_FRAGMENT_SHADER_INVOCATIONS : GL_SAMPLES_PASSED;
+        glGenQueries(RING, queries);
+    }
+
+    void begin() {
+        if (pending[current]) collect(current); // Slot ancora in volo: prova a leggerlo prima di riusarlo
+        if (pending[current]) return;           // Non ancora pronto: salta la misura di questo frame
+        glBeginQuery(target, queries[current]);
+        active = true;
+    }
+
+    void end() {
+        if (!active) return;
+        glEndQuery(target);
+        active = false;
+        pending[current] = true;
+        current = (current + 1) % RING;
+        // Il più vecchio dei risultati in volo, se pronto
+        collect(current);
+    }
+
+    uint64_t lastCount() const { return last; }
+    bool measuresInvocations() const { return countsInvocations; }
+
+private:
+    static constexpr int RING = 4;
+    unsigned int queries[RING]{};
+    bool pending[RING]{};
+    int current = 0;
+    bool active = false;
+    bool countsInvocations = false;
+    unsigned int target = GL_SAMPLES_PASSED;
+    uint64_t last = 0;
+
+    void collect(int slot) {
+        if (!pending[slot]) return;
+        int available = 0;
+        glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return;
+        GLuint64 result = 0;
+        glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &result);
+        last = result;
+        pending[slot] = false;
+    }
+};
+
+#endif
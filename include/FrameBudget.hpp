@@ -0,0 +1,60 @@
+#ifndef FRAMEBUDGET_H
+#define FRAMEBUDGET_H
+
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+// Budget di tempo per il lavoro del thread principale in un frame (upload GL, drain dei job, unload/salvataggi).
+// Ogni fase lavora finché resta budget, con almeno un elemento per frame per non bloccarsi;
+// quello che resta viene rinviato al frame successivo e contato nella telemetria.
+class FrameBudget {
+public:
+    explicit FrameBudget(double budgetMs) : budgetMs(budgetMs) {}
+
+    void beginFrame() {
+        start = std::chrono::steady_clock::now();
+        deferredThisFrame = 0;
+    }
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool hasTime() const { return elapsedMs() < budgetMs; }
+
+    // Il primo elemento di una fase passa sempre (progresso garantito), i successivi solo se resta tempo
+    bool allows(int doneInPhase) const { return doneInPhase == 0 || hasTime(); }
+
+    // Lavoro rimandato al prossimo frame
+    void defer(size_t items = 1) { deferredThisFrame += items; }
+
+    void endFrame() {
+        lastMs = elapsedMs();
+        maxMs = std::max(maxMs, lastMs);
+        lastDeferred = deferredThisFrame;
+        totalDeferred += deferredThisFrame;
+        frames++;
+        if (lastMs > budgetMs) overruns++;
+    }
+
+    // --- Telemetria ---
+    double budget() const { return budgetMs; }
+    double lastFrameMs() const { return lastMs; }
+    double maxFrameMs() const { return maxMs; }
+    size_t lastFrameDeferred() const { return lastDeferred; }
+    size_t totalDeferredItems() const { return totalDeferred; }
+    size_t overrunFrames() const { return overruns; }
+    size_t frameCount() const { return frames; }
+
+private:
+    double budgetMs;
+    std::chrono::steady_clock::time_point start{};
+    size_t deferredThisFrame = 0;
+
+    double lastMs = 0.0, maxMs = 0.0;
+    size_t lastDeferred = 0, totalDeferred = 0;
+    size_t overruns = 0, frames = 0;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef GLHEADERS_H
+#define GLHEADERS_H
+
+// Header OpenGL per piattaforma: includere questo (prima di GLFW) invece degli header di sistema.
+// - macOS: OpenGL/gl3.h, core profile fermo a 4.1
+// - Linux e altri: GL/gl.h + GL/glext.h con i prototipi (libGL di Mesa esporta tutto il core fino a 4.6).
+//   Le funzioni oltre la versione del contesto vanno comunque controllate a runtime (vedi ChunkDrawBatch::init)
+#ifdef __APPLE__
+#ifndef GL_SILENCE_DEPRECATION
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <OpenGL/gl3.h>
+#else
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef OCCLUSIONCULLER_H
+#define OCCLUSIONCULLER_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <glm/glm.hpp>
+
+// Box allineato agli assi, in coordinate mondo
+struct CullBox {
+    glm::vec3 min, max;
+};
+
+// Occlusion culling software: depth buffer grezzo (256x128) sulla CPU, su un thread dedicato.
+// Il thread principale riempie occluders (box pieni dei chunk vicini) e queries (box dei chunk che passano
+// il frustum), chiama start() e fa altro lavoro del frame; wait() restituisce per ogni query se è visibile.
+// Gli occluder sono rasterizzati con il campione al centro del pixel: uno scarto di mezzo pixel ai bordi
+// è accettato (buffer grezzo). Le query invece sono conservative: rettangolo pieno e profondità minima.
+class OcclusionCuller {
+public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+
+    OcclusionCuller();
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    // Liste da riempire prima di start() (solo thread principale, mai tra start() e wait())
+    std::vector<CullBox> occluders;
+    std::vector<CullBox> queries;
+
+    void start(const glm::mat4& viewProjection, const glm::vec3& cameraPos);
+    // Blocca finché il thread non ha finito; visible[i] corrisponde a queries[i]
+    const std::vector<unsigned char>& wait();
+
+    // Telemetria dell'ultimo passaggio
+    size_t lastTested() const { return queries.size(); }
+    size_t lastOccluded() const { return occludedCount; }
+    double lastMs() const { return elapsedMs; }
+
+private:
+    std::vector<float> depth; // NDC z in [-1, 1], il più vicino per pixel (1 = vuoto)
+    std::vector<unsigned char> visible;
+    glm::mat4 viewProj{1.0f};
+    glm::vec3 eye{0.0f};
+    size_t occludedCount = 0;
+    double elapsedMs = 0.0;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool hasWork = false;
+    bool busy = false;
+    bool quit = false;
+
+    void workerLoop();
+    void run();
+    void rasterizeBox(const CullBox& box);
+    void rasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+    bool isBoxVisible(const CullBox& box) const;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SECTIONVISIBILITY_H
+#define SECTIONVISIBILITY_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "Camera.hpp"
+#include "Chunk.hpp"
+
+// Cave culling: visita in ampiezza delle sezioni 16x16x16 a partire da quella della camera.
+// Da una sezione si esce da una faccia solo se è collegata (Chunk::sectionConnectivity) alla faccia da cui
+// si è entrati, mai tornando in una direzione opposta a una già presa, e solo verso sezioni nel frustum.
+// Sottoterra la visita resta nelle gallerie raggiungibili: i chunk di superficie non vengono disegnati.
+// Solo thread principale.
+class SectionVisibility {
+public:
+    // Raggio della griglia attorno alla camera: copre tutti i chunk caricati
+    static constexpr int RADIUS = WorldConfig::UNLOAD_DISTANCE + 1;
+
+    void compute(const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks, const Camera& camera);
+
+    // Un bit per sezione raggiunta. Tutte accese se la visita non è attiva (camera fuori dal mondo o nel vuoto)
+    unsigned char visibleSections(int chunkX, int chunkZ) const;
+
+    bool isActive() const { return active; }
+    size_t lastVisited() const { return visited; }
+
+private:
+    static constexpr int SIDE = 2 * RADIUS + 1;
+
+    struct Node {
+        int x, z;                 // Cella della griglia
+        int y;                    // Sezione
+        int entry;                // Faccia da cui si è entrati (-1 per la sezione della camera)
+        unsigned char directions; // Direzioni già prese (bit per faccia)
+    };
+
+    std::vector<const Chunk*> grid = std::vector<const Chunk*>(SIDE * SIDE);
+    std::vector<unsigned char> reached = std::vector<unsigned char>(SIDE * SIDE); // Bit per sezione
+    std::vector<Node> queue;
+    int originX = 0, originZ = 0; // Chunk nella cella (0, 0)
+    bool active = false;
+    size_t visited = 0;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define SHADER_H
 
 #include <string>
+#include <unordered_map>
 #include <glm/glm.hpp> // Serve per mat4
 
 class Shader {
@@ -10,10 +11,26 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     void use() const;
 
+    // Location risolte una volta dopo il link (-1 se la uniform non esiste o è stata eliminata dal compilatore).
+    // Nel render loop conviene salvarla e usare gli overload per location: nessuna ricerca per stringa.
+    int uniformLocation(const std::string &name) const;
+
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
 
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+    void setInt(int location, int value) const;
+    void setIVec2(int location, int x, int y) const;
+    void setMat4(int location, const glm::mat4 &mat) const;
+
+    // Collega un blocco uniform dello shader (es. "CameraBlock") a un binding point di UBO
+    void bindUniformBlock(const std::string &blockName, unsigned int bindingPoint) const;
+
+private:
+    std::unordered_map<std::string, int> uniformLocations;
+
+    void cacheUniformLocations();
 };
 #endif
\ No newline at end of file
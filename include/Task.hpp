@@ -0,0 +1,83 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Callable move-only con buffer interno (small-buffer optimization), al posto di std::function<void()>.
+// Il callable vive sempre nel buffer: costruire, spostare ed eseguire un Task non alloca mai.
+// Un callable troppo grande è un errore di compilazione: catturare puntatori, non contenitori.
+class Task {
+public:
+    static constexpr size_t CAPACITY = 48;
+
+    Task() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= CAPACITY, "Task: callable troppo grande per il buffer interno");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Task: allineamento non supportato");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "Task: il callable deve avere un move noexcept");
+        new (storage) Fn(std::forward<F>(f));
+        ops = &opsFor<Fn>;
+    }
+
+    Task(Task&& other) noexcept { moveFrom(other); }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    // Tabella per tipo: invoca, sposta (costruisce in dst e distrugge src), distrugge
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template<typename Fn>
+    static constexpr Ops opsFor = {
+        [](void* p) { (*static_cast<Fn*>(p))(); },
+        [](void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* p) { static_cast<Fn*>(p)->~Fn(); }
+    };
+
+    alignas(std::max_align_t) unsigned char storage[CAPACITY];
+    const Ops* ops = nullptr;
+
+    void moveFrom(Task& other) {
+        if (!other.ops) return;
+        other.ops->move(storage, other.storage);
+        ops = other.ops;
+        other.ops = nullptr;
+    }
+};
+
+#endif
@@ -2,61 +2,202 @@
 #define THREADPOOL_H
 
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <functional>
 #include <future>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include "Task.hpp"
 
+// Thread pool work-stealing: ogni worker ha la sua deque (lock per-deque, mai condivisa da tutti).
+// - submit dal thread principale: distribuito round-robin sulle deque
+// - submit da un worker (es. generazione che lancia il meshing): sulla deque del worker stesso
+// - un worker consuma la propria deque dal fondo (LIFO, dati ancora in cache)
+//   e quando è vuota ruba dalla testa delle deque altrui (FIFO, i task più vecchi)
+// I task sono Task (move-only, senza allocazioni) in buffer circolari che a regime non riallocano.
+// Un worker senza lavoro riprova pochi giri, poi si parcheggia sulla condition variable (con timeout
+// crescente se un push è a metà): i worker inattivi non tolgono CPU né lock a chi produce i task.
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t numThreads) : stop(false) {
-        for (size_t i = 0; i < numThreads; i++) {
-            workers.emplace_back([this]() {
-                while (true) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock<std::mutex> lock(queueMutex);
-                        condition.wait(lock, [this]() { return stop || !tasks.empty(); });
-                        if (stop && tasks.empty()) return;
-                        task = std::move(tasks.front());
-                        tasks.pop();
-                    }
-                    task();
-                }
-            });
-        }
+    explicit ThreadPool(size_t numThreads) {
+        for (size_t i = 0; i < numThreads; i++)
+            queues.push_back(std::make_unique<WorkerQueue>());
+        for (size_t i = 0; i < numThreads; i++)
+            workers.emplace_back([this, i]() { workerLoop(i); });
     }
 
     ~ThreadPool() {
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
+            std::unique_lock<std::mutex> lock(sleepMutex);
             stop = true;
         }
-        condition.notify_all();
+        wake.notify_all();
         for (auto& worker : workers)
             worker.join();
     }
 
+    // Con future: un'allocazione per lo stato condiviso (strumenti, caricamento iniziale)
     template<typename F>
     std::future<void> submit(F&& f) {
-        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
-        std::future<void> result = task->get_future();
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            tasks.emplace([task]() { (*task)(); });
-        }
-        condition.notify_one();
+        std::packaged_task<void()> task(std::forward<F>(f));
+        std::future<void> result = task.get_future();
+        push(Task([task = std::move(task)]() mutable { task(); }));
         return result;
     }
 
+    // Senza future né allocazioni: chi ha bisogno del completamento lo segnala dal task stesso (es. CompletionQueue)
+    template<typename F>
+    void post(F&& f) {
+        push(Task(std::forward<F>(f)));
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Task in coda non ancora presi da un worker
+    size_t pendingCount() const { return pending.load(std::memory_order_relaxed); }
+
 private:
+    // Deque su buffer circolare (capacità potenza di 2): cresce raddoppiando, poi non alloca più
+    class TaskRing {
+    public:
+        bool empty() const { return count == 0; }
+
+        void pushBack(Task&& task) {
+            if (count == slots.size()) grow();
+            slots[(head + count) & (slots.size() - 1)] = std::move(task);
+            count++;
+        }
+
+        Task popBack() {
+            count--;
+            return std::move(slots[(head + count) & (slots.size() - 1)]);
+        }
+
+        Task popFront() {
+            Task task = std::move(slots[head]);
+            head = (head + 1) & (slots.size() - 1);
+            count--;
+            return task;
+        }
+
+    private:
+        std::vector<Task> slots;
+        size_t head = 0, count = 0;
+
+        void grow() {
+            std::vector<Task> bigger(slots.empty() ? 64 : slots.size() * 2);
+            for (size_t i = 0; i < count; i++)
+                bigger[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+            slots.swap(bigger);
+            head = 0;
+        }
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        TaskRing tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
-    std::mutex queueMutex;
-    std::condition_variable condition;
-    bool stop;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<size_t> sleepers{0}; // Worker parcheggiati (o in procinto): solo allora push sveglia qualcuno
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stop = false;
+
+    // Worker corrente (nullptr/0 se il thread non appartiene a questo pool)
+    static inline thread_local ThreadPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+
+    void push(Task&& task) {
+        size_t index = (currentPool == this)
+            ? currentIndex
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        // Prima il contatore: un worker può trovare il task solo dopo averlo visto
+        pending.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.pushBack(std::move(task));
+        }
+
+        // seq_cst con il sleepers++ del worker: o qui si vede il worker, o il worker vede il nuovo pending.
+        // Con tutti i worker occupati nessun lock né notify
+        if (sleepers.load(std::memory_order_seq_cst) == 0) return;
+        // Lock vuoto: il worker che ha appena contato se stesso è già dentro wait quando arriva il notify
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+
+    bool tryPop(size_t self, Task& out) {
+        {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                out = own.tasks.popBack();
+                return true;
+            }
+        }
+        // Primo giro senza attendere i lock occupati, secondo giro bloccante
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t i = 1; i < queues.size(); i++) {
+                WorkerQueue& victim = *queues[(self + i) % queues.size()];
+                std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+                if (pass == 0) {
+                    if (!lock.try_lock()) continue;
+                } else {
+                    lock.lock();
+                }
+                if (victim.tasks.empty()) continue;
+                out = victim.tasks.popFront();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Giri di furto falliti prima di parcheggiarsi, e attesa massima quando pending > 0 ma la coda sembra vuota
+    static constexpr int SPIN_ROUNDS = 8;
+    static constexpr std::chrono::microseconds MAX_BACKOFF{1000};
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        Task task;
+        int failedRounds = 0;
+        std::chrono::microseconds backoff{10};
+        while (true) {
+            if (tryPop(index, task)) {
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                task.reset();
+                failedRounds = 0;
+                backoff = std::chrono::microseconds{10};
+                continue;
+            }
+            if (++failedRounds < SPIN_ROUNDS) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (pending.load(std::memory_order_seq_cst) > 0) {
+                // Task contati ma non trovati: un push è a metà o altri worker li stanno prendendo.
+                // Attesa breve che raddoppia a ogni giro a vuoto (un push la interrompe)
+                wake.wait_for(lock, backoff);
+                backoff = std::min(backoff * 2, MAX_BACKOFF);
+            } else {
+                wake.wait(lock, [this]() { return stop || pending.load(std::memory_order_seq_cst) > 0; });
+            }
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (stop && pending.load(std::memory_order_acquire) == 0) return;
+            failedRounds = 0;
+        }
+    }
 };
 
 #endif
@@ -15,6 +15,13 @@ void main() {
         texColor.rgb *= grassTint;
     }
 
+    // Tinta per le foglie (texture in scala di grigi): quercia (15) e abete (18)
+    if (abs(TexCoords.z - 15.0) < 0.1) {
+        texColor.rgb *= vec3(0.47, 0.75, 0.30);
+    } else if (abs(TexCoords.z - 18.0) < 0.1) {
+        texColor.rgb *= vec3(0.38, 0.60, 0.38);
+    }
+
     // Applica illuminazione per faccia
     texColor.rgb *= Brightness;
 
@@ -6,12 +6,15 @@ layout (location = 2) in float aBrightness;
 out vec3 TexCoords;
 out float Brightness;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Aggiornato una volta per frame, condiviso da tutti gli shader dei chunk (binding point 0)
+layout (std140) uniform CameraBlock {
+    mat4 projection;
+    mat4 view;
+};
+uniform ivec2 chunkOffset; // Origine del chunk in blocchi (x, z)
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * vec4(aPos + vec3(chunkOffset.x, 0.0, chunkOffset.y), 1.0);
     TexCoords = aTexData;
     Brightness = aBrightness;
 }
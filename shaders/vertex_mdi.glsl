@@ -0,0 +1,19 @@
+#version 410 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aTexData; // U, V, Layer
+layout (location = 2) in float aBrightness;
+layout (location = 3) in vec2 aChunkOffset; // Per istanza: scelto da baseInstance del comando indiretto
+
+out vec3 TexCoords;
+out float Brightness;
+
+layout (std140) uniform CameraBlock {
+    mat4 projection;
+    mat4 view;
+};
+
+void main() {
+    gl_Position = projection * view * vec4(aPos + vec3(aChunkOffset.x, 0.0, aChunkOffset.y), 1.0);
+    TexCoords = aTexData;
+    Brightness = aBrightness;
+}
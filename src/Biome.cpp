@@ -0,0 +1,92 @@
+#include "Biome.hpp"
+
+namespace {
+    // base, amplitude, top, filler, fillerDepth, treeChance, tree
+    const BiomeParams BIOME_TABLE[BiomeType::COUNT] = {
+        { 30.0f, 12.0f, BlockType::GRASS,    BlockType::DIRT,       3, 0.002f, TreeType::OAK    }, // PLAINS
+        { 32.0f, 18.0f, BlockType::GRASS,    BlockType::DIRT,       3, 0.025f, TreeType::OAK    }, // FOREST
+        { 30.0f,  8.0f, BlockType::SAND,     BlockType::SANDSTONE,  4, 0.0f,   TreeType::NONE   }, // DESERT
+        { 34.0f, 22.0f, BlockType::RED_SAND, BlockType::TERRACOTTA, 6, 0.0f,   TreeType::NONE   }, // BADLANDS
+        { 34.0f, 20.0f, BlockType::PODZOL,   BlockType::DIRT,       3, 0.02f,  TreeType::SPRUCE }, // TAIGA
+        { 32.0f, 14.0f, BlockType::SNOW,     BlockType::DIRT,       3, 0.004f, TreeType::SPRUCE }, // SNOWY
+        { 44.0f, 30.0f, BlockType::GRAVEL,   BlockType::STONE,      1, 0.0f,   TreeType::NONE   }, // MOUNTAINS
+    };
+
+    // Hash intero deterministico per colonna, usato per il dithering dei bordi tra biomi
+    float columnDither(int worldX, int worldZ, int seed) {
+        unsigned int h = static_cast<unsigned int>(worldX) * 73856093u
+                       ^ static_cast<unsigned int>(worldZ) * 19349663u
+                       ^ static_cast<unsigned int>(seed) * 83492791u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+        return static_cast<float>(h & 0xFFFFu) / 65536.0f;
+    }
+}
+
+const BiomeParams& getBiomeParams(unsigned char biome) {
+    return BIOME_TABLE[biome < BiomeType::COUNT ? biome : BiomeType::PLAINS];
+}
+
+BiomeMap::BiomeMap(int seed) : seed(seed), temperature(seed + 1), humidity(seed + 2) {
+    temperature.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    temperature.SetFrequency(WorldConfig::BIOME_FREQUENCY);
+    humidity.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    humidity.SetFrequency(WorldConfig::BIOME_FREQUENCY);
+}
+
+unsigned char BiomeMap::biomeAt(float worldX, float worldZ) const {
+    float t = temperature.GetNoise(worldX, worldZ);
+    float h = humidity.GetNoise(worldX, worldZ);
+
+    if (t < -0.4f) return (h < 0.0f) ? BiomeType::SNOWY : BiomeType::TAIGA;
+    if (t > 0.45f) return (h < 0.0f) ? BiomeType::DESERT : BiomeType::BADLANDS;
+    if (h > 0.25f) return BiomeType::FOREST;
+    if (h < -0.35f) return BiomeType::MOUNTAINS;
+    return BiomeType::PLAINS;
+}
+
+void BiomeMap::sampleChunk(int chunkX, int chunkZ, ColumnBiome out[Chunk::SIZE][Chunk::SIZE]) const {
+    constexpr int CELL = WorldConfig::BIOME_CELL;
+    constexpr int GRID = Chunk::SIZE / CELL + 1;
+
+    // Campiona gli angoli delle celle: coordinate mondo multiple di CELL,
+    // quindi chunk adiacenti condividono gli stessi campioni sul bordo
+    unsigned char grid[GRID][GRID];
+    const int baseX = chunkX * Chunk::SIZE;
+    const int baseZ = chunkZ * Chunk::SIZE;
+    for (int gx = 0; gx < GRID; gx++) {
+        for (int gz = 0; gz < GRID; gz++) {
+            grid[gx][gz] = biomeAt(static_cast<float>(baseX + gx * CELL), static_cast<float>(baseZ + gz * CELL));
+        }
+    }
+
+    for (int x = 0; x < Chunk::SIZE; x++) {
+        int gx = x / CELL;
+        float fx = static_cast<float>(x % CELL) / CELL;
+        for (int z = 0; z < Chunk::SIZE; z++) {
+            int gz = z / CELL;
+            float fz = static_cast<float>(z % CELL) / CELL;
+
+            const unsigned char corners[4] = { grid[gx][gz], grid[gx + 1][gz], grid[gx][gz + 1], grid[gx + 1][gz + 1] };
+            const float weights[4] = { (1 - fx) * (1 - fz), fx * (1 - fz), (1 - fx) * fz, fx * fz };
+
+            ColumnBiome& col = out[x][z];
+            col.base = 0.0f;
+            col.amplitude = 0.0f;
+            for (int i = 0; i < 4; i++) {
+                const BiomeParams& p = getBiomeParams(corners[i]);
+                col.base += p.base * weights[i];
+                col.amplitude += p.amplitude * weights[i];
+            }
+
+            // Superficie: angolo estratto con probabilità pari al suo peso bilineare
+            float r = columnDither(baseX + x, baseZ + z, seed);
+            col.biome = corners[3];
+            for (int i = 0; i < 4; i++) {
+                if (r < weights[i]) { col.biome = corners[i]; break; }
+                r -= weights[i];
+            }
+        }
+    }
+}
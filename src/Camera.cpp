@@ -86,7 +86,7 @@ void Camera::updateFrustum(float aspect, float fov, float nearPlane, float farPl
     frustum.update(proj * view);
 }
 
-bool Camera::checkCollision(glm::vec3 nextPos, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks) const {
+bool Camera::checkCollision(glm::vec3 nextPos, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks) const {
     float halfWidth = width / 2.0f;
     float minX = nextPos.x - halfWidth;
     float maxX = nextPos.x + halfWidth;
@@ -119,7 +119,7 @@ bool Camera::checkCollision(glm::vec3 nextPos, const std::unordered_map<long lon
                     int localZ = z % 16; if (localZ < 0) localZ += 16;
 
                     if (y >= 0 && y < Chunk::HEIGHT) {
-                        if (chunk->blocks[localX][y][localZ] != 0) {
+                        if (chunk->getBlock(localX, y, localZ) != 0) {
                             return true;
                         }
                     }
@@ -130,7 +130,7 @@ bool Camera::checkCollision(glm::vec3 nextPos, const std::unordered_map<long lon
     return false;
 }
 
-void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks) {
+void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks) {
     float velocity = MovementSpeed * deltaTime;
     glm::vec3 forward = glm::normalize(glm::vec3(Front.x, 0.0f, Front.z));
     glm::vec3 right = glm::normalize(glm::vec3(Right.x, 0.0f, Right.z));
@@ -159,7 +159,7 @@ void Camera::ProcessJump() {
     }
 }
 
-void Camera::UpdatePhysics(float deltaTime, const std::unordered_map<long long, std::unique_ptr<Chunk>>& chunks) {
+void Camera::UpdatePhysics(float deltaTime, const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks) {
     yVelocity += PlayerConfig::GRAVITY * deltaTime;
     if (yVelocity < PlayerConfig::MAX_FALL_SPEED) yVelocity = PlayerConfig::MAX_FALL_SPEED;
 
@@ -1,18 +1,35 @@
-#define GL_SILENCE_DEPRECATION
 #include "Chunk.hpp"
+#include "Biome.hpp"
 #include "FastNoiseLite.h"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Vertici della mesh in costruzione, uno per direzione di faccia (ordine di SectionFace).
+    // Per thread: niente memoria extra per chunk e capacità riusata da una mesh all'altra
+    thread_local std::vector<float> faceBuckets[SectionFace::COUNT];
+    // Blocchi ridotti di una mesh LOD: cella (cx, cz, cy) in [(cx * celle + cz) * celleY + cy]
+    thread_local std::vector<unsigned char> lodCells;
+}
 
 Chunk::Chunk(int cx, int cz) : chunkX(cx), chunkZ(cz) {
+    for (int s = 0; s < SECTIONS; s++) {
+        sectionConnectivity[s] = ALL_FACES_CONNECTED;
+        pendingConnectivity[s] = ALL_FACES_CONNECTED;
+    }
 }
 
 Chunk::~Chunk() {
+    releaseMesh();
+}
+
+void Chunk::releaseMesh() {
     if (isUploaded) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
+        arena->release(mesh);
+        isUploaded = false;
     }
 }
 
@@ -21,51 +38,192 @@ void Chunk::generate() {
     // generateMesh viene chiamata da rebuild() con i vicini disponibili
 }
 
-void Chunk::generateTerrain() {
-    FastNoiseLite noise;
+void Chunk::generateTerrain(int seed) {
+    FastNoiseLite noise(seed);
     noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
     noise.SetFrequency(WorldConfig::NOISE_FREQUENCY);
 
+    // Parametri di altezza e bioma di superficie per colonna, già interpolati
+    BiomeMap biomeMap(seed);
+    ColumnBiome columns[SIZE][SIZE];
+    biomeMap.sampleChunk(chunkX, chunkZ, columns);
+
+    // Ogni colonna è sempre bedrock | pietra | filler | superficie | aria:
+    // la descriviamo come run e la scriviamo con riempimenti contigui
+    columnRuns.clear();
+    columnRuns.reserve(SIZE * SIZE * 5);
     for (int x = 0; x < SIZE; x++) {
         for (int z = 0; z < SIZE; z++) {
             float worldX = static_cast<float>(x + chunkX * SIZE);
             float worldZ = static_cast<float>(z + chunkZ * SIZE);
 
+            const ColumnBiome& col = columns[x][z];
+            const BiomeParams& surface = getBiomeParams(col.biome);
+
             float noiseValue = noise.GetNoise(worldX, worldZ);
-            int terrainHeight = static_cast<int>((noiseValue + 1.0f) * WorldConfig::TERRAIN_AMPLITUDE + WorldConfig::TERRAIN_BASE);
-
-            for (int y = 0; y < HEIGHT; y++) {
-                if (y == 0) {
-                    blocks[x][y][z] = BlockType::BEDROCK;
-                } else if (y < terrainHeight - 3) {
-                    blocks[x][y][z] = BlockType::STONE;
-                } else if (y < terrainHeight) {
-                    blocks[x][y][z] = BlockType::DIRT;
-                } else if (y == terrainHeight) {
-                    blocks[x][y][z] = BlockType::GRASS;
-                } else {
-                    blocks[x][y][z] = BlockType::AIR;
+            int terrainHeight = static_cast<int>((noiseValue + 1.0f) * col.amplitude + col.base);
+            if (terrainHeight > HEIGHT - 1) terrainHeight = HEIGHT - 1;
+
+            int stoneEnd = std::max(1, terrainHeight - surface.fillerDepth);
+            int fillerEnd = std::max(stoneEnd, terrainHeight);
+            int topEnd = std::max(1, terrainHeight + 1);
+
+            runOffset[x * SIZE + z] = static_cast<unsigned short>(columnRuns.size());
+            auto addRun = [&](unsigned char block, int from, int to) {
+                if (to > from) columnRuns.push_back({ block, static_cast<unsigned char>(to - from) });
+            };
+            addRun(BlockType::BEDROCK, 0, 1);
+            addRun(BlockType::STONE, 1, stoneEnd);
+            addRun(surface.filler, stoneEnd, fillerEnd);
+            addRun(surface.top, fillerEnd, topEnd);
+            addRun(BlockType::AIR, topEnd, HEIGHT);
+        }
+    }
+    runOffset[SIZE * SIZE] = static_cast<unsigned short>(columnRuns.size());
+
+    applyColumnRuns(true);
+    spillReceived = 0;
+}
+
+void Chunk::applyColumnRuns(bool fillBlocks) {
+    for (int s = 0; s < SECTIONS; s++) sectionBlock[s] = MIXED_SECTION;
+
+    for (int x = 0; x < SIZE; x++) {
+        for (int z = 0; z < SIZE; z++) {
+            const int c = x * SIZE + z;
+            unsigned char* column = blocks[x][z];
+            int y = 0;
+            int top = 0;
+            for (int r = runOffset[c]; r < runOffset[c + 1]; r++) {
+                const BlockRun& run = columnRuns[r];
+                if (fillBlocks) std::memset(column + y, run.block, run.length);
+                if (run.block != BlockType::AIR) top = y + run.length;
+
+                // Uniformità di sezione: la sezione deve stare dentro un unico run in ogni colonna
+                for (int s = y / SECTION_SIZE; s < SECTIONS && s * SECTION_SIZE < y + run.length; s++) {
+                    bool covers = (s * SECTION_SIZE >= y) && ((s + 1) * SECTION_SIZE <= y + run.length);
+                    unsigned char value = covers ? run.block : MIXED_SECTION;
+                    if (c == 0 && s * SECTION_SIZE >= y) sectionBlock[s] = value;
+                    else if (sectionBlock[s] != value) sectionBlock[s] = MIXED_SECTION;
                 }
+                y += run.length;
             }
+            heightMap[x][z] = static_cast<unsigned char>(top);
         }
     }
+    dirtyColumns.reset();
+    dirtySections.store(0xFF, std::memory_order_relaxed);
+}
+
+void Chunk::encodeColumn(int x, int z, std::vector<BlockRun>& out) const {
+    const unsigned char* column = blocks[x][z];
+    int y = 0;
+    while (y < HEIGHT) {
+        int start = y;
+        unsigned char block = column[y];
+        while (y < HEIGHT && column[y] == block) y++;
+        out.push_back({ block, static_cast<unsigned char>(y - start) });
+    }
 }
 
-void Chunk::addFace(int x, int y, int z, std::string faceType, unsigned char blockID) {
-    float layer = 0.0f;
+void Chunk::setBlock(int x, int y, int z, unsigned char block) {
+    blocks[x][z][y] = block;
+    dirtyColumns.set(x * SIZE + z);
 
-    if (blockID == BlockType::GRASS) {
-        if (faceType == "TOP") layer = TextureLayer::GRASS_TOP;
-        else if (faceType == "BOTTOM") layer = TextureLayer::DIRT;
-        else layer = TextureLayer::GRASS_SIDE;
-    } else if (blockID == BlockType::DIRT) {
-        layer = TextureLayer::DIRT;
-    } else if (blockID == BlockType::STONE) {
-        layer = TextureLayer::STONE;
-    } else if (blockID == BlockType::BEDROCK) {
-        layer = TextureLayer::BEDROCK;
+    unsigned char& top = heightMap[x][z];
+    if (block != BlockType::AIR && y >= top) {
+        top = static_cast<unsigned char>(y + 1);
+    } else if (block == BlockType::AIR && y + 1 == top) {
+        while (top > 0 && blocks[x][z][top - 1] == BlockType::AIR) top--;
     }
 
+    unsigned char& section = sectionBlock[y / SECTION_SIZE];
+    if (section != block) section = MIXED_SECTION;
+    dirtySections.fetch_or(static_cast<unsigned char>(1u << (y / SECTION_SIZE)), std::memory_order_relaxed);
+}
+
+uint64_t Chunk::computeSectionConnectivity(int section) const {
+    // Sezioni uniformi: tutta piena (nessun passaggio) o tutta attraversabile
+    unsigned char uniform = sectionBlock[section];
+    if (uniform != MIXED_SECTION)
+        return isTransparent(uniform) ? ALL_FACES_CONNECTED : 0;
+
+    constexpr int S = SECTION_SIZE;
+    const int baseY = section * S;
+    // Indice di cella: (x * S + z) * S + y, come il layout y-contiguo di blocks
+    std::bitset<S * S * S> visited;
+    unsigned short stack[S * S * S];
+    uint64_t connectivity = 0;
+
+    for (int start = 0; start < S * S * S; start++) {
+        if (visited[start]) continue;
+        int sx = start / (S * S), sz = (start / S) % S, sy = start % S;
+        if (!isTransparent(blocks[sx][sz][baseY + sy])) continue;
+
+        // Flood fill della componente non opaca: raccoglie le facce della sezione che tocca
+        unsigned int faces = 0;
+        int top = 0;
+        stack[top++] = static_cast<unsigned short>(start);
+        visited.set(start);
+        while (top > 0) {
+            int cell = stack[--top];
+            int x = cell / (S * S), z = (cell / S) % S, y = cell % S;
+            if (x == 0) faces |= 1u << SectionFace::NEG_X;
+            if (x == S - 1) faces |= 1u << SectionFace::POS_X;
+            if (y == 0) faces |= 1u << SectionFace::NEG_Y;
+            if (y == S - 1) faces |= 1u << SectionFace::POS_Y;
+            if (z == 0) faces |= 1u << SectionFace::NEG_Z;
+            if (z == S - 1) faces |= 1u << SectionFace::POS_Z;
+
+            auto visit = [&](int nx, int ny, int nz) {
+                int next = (nx * S + nz) * S + ny;
+                if (visited[next] || !isTransparent(blocks[nx][nz][baseY + ny])) return;
+                visited.set(next);
+                stack[top++] = static_cast<unsigned short>(next);
+            };
+            if (x > 0) visit(x - 1, y, z);
+            if (x < S - 1) visit(x + 1, y, z);
+            if (y > 0) visit(x, y - 1, z);
+            if (y < S - 1) visit(x, y + 1, z);
+            if (z > 0) visit(x, y, z - 1);
+            if (z < S - 1) visit(x, y, z + 1);
+        }
+
+        for (int a = 0; a < SectionFace::COUNT; a++)
+            for (int b = 0; b < SectionFace::COUNT; b++)
+                if ((faces >> a & 1) && (faces >> b & 1))
+                    connectivity |= uint64_t(1) << (a * SectionFace::COUNT + b);
+        if (connectivity == ALL_FACES_CONNECTED) break;
+    }
+    return connectivity;
+}
+
+void Chunk::addFace(int x, int y, int z, std::string faceType, unsigned char blockID, int size) {
+    // Layer della texture array per faccia: { top, lati, bottom }
+    static const float BLOCK_LAYERS[BlockType::COUNT][3] = {
+        { 0, 0, 0 },                                                                   // AIR
+        { TextureLayer::GRASS_TOP, TextureLayer::GRASS_SIDE, TextureLayer::DIRT },       // GRASS
+        { TextureLayer::DIRT, TextureLayer::DIRT, TextureLayer::DIRT },                  // DIRT
+        { TextureLayer::STONE, TextureLayer::STONE, TextureLayer::STONE },               // STONE
+        { TextureLayer::BEDROCK, TextureLayer::BEDROCK, TextureLayer::BEDROCK },         // BEDROCK
+        { TextureLayer::SAND, TextureLayer::SAND, TextureLayer::SAND },                  // SAND
+        { TextureLayer::SANDSTONE, TextureLayer::SANDSTONE, TextureLayer::SANDSTONE },   // SANDSTONE
+        { TextureLayer::SNOW, TextureLayer::SNOW, TextureLayer::SNOW },                  // SNOW
+        { TextureLayer::RED_SAND, TextureLayer::RED_SAND, TextureLayer::RED_SAND },      // RED_SAND
+        { TextureLayer::TERRACOTTA, TextureLayer::TERRACOTTA, TextureLayer::TERRACOTTA },// TERRACOTTA
+        { TextureLayer::GRAVEL, TextureLayer::GRAVEL, TextureLayer::GRAVEL },            // GRAVEL
+        { TextureLayer::PODZOL_TOP, TextureLayer::PODZOL_SIDE, TextureLayer::DIRT },     // PODZOL
+        { TextureLayer::OAK_LOG_TOP, TextureLayer::OAK_LOG_SIDE, TextureLayer::OAK_LOG_TOP },          // OAK_LOG
+        { TextureLayer::OAK_LEAVES, TextureLayer::OAK_LEAVES, TextureLayer::OAK_LEAVES },              // OAK_LEAVES
+        { TextureLayer::SPRUCE_LOG_TOP, TextureLayer::SPRUCE_LOG_SIDE, TextureLayer::SPRUCE_LOG_TOP }, // SPRUCE_LOG
+        { TextureLayer::SPRUCE_LEAVES, TextureLayer::SPRUCE_LEAVES, TextureLayer::SPRUCE_LEAVES },     // SPRUCE_LEAVES
+    };
+
+    const float* layers = BLOCK_LAYERS[blockID < BlockType::COUNT ? blockID : BlockType::STONE];
+    float layer = layers[1];
+    if (faceType == "TOP") layer = layers[0];
+    else if (faceType == "BOTTOM") layer = layers[2];
+
     // Luminosità per faccia (simula luce direzionale dall'alto)
     float brightness = 0.8f; // default laterali
     if (faceType == "TOP")         brightness = 1.0f;
@@ -73,134 +231,272 @@ void Chunk::addFace(int x, int y, int z, std::string faceType, unsigned char blo
     else if (faceType == "FRONT" || faceType == "BACK") brightness = 0.7f;
     else /* LEFT, RIGHT */         brightness = 0.8f;
 
-    // Stride: 7 floats per vertice (pos3 + tex3 + brightness1)
-    const auto startIdx = static_cast<unsigned int>(vertices.size() / 7);
-
+    // Stride: 7 floats per vertice (pos3 + tex3 + brightness1), 4 vertici per quad.
+    // Nessun indice: i triangoli 0,1,2 / 0,2,3 di ogni quad vengono dal buffer condiviso dell'arena.
+    // U/V vanno da 0 a size: con GL_REPEAT la texture si ripete una volta per blocco anche sulle celle LOD
     float x0 = static_cast<float>(x);
-    float x1 = static_cast<float>(x + 1);
+    float x1 = static_cast<float>(x + size);
     float y0 = static_cast<float>(y);
-    float y1 = static_cast<float>(y + 1);
+    float y1 = static_cast<float>(y + size);
     float z0 = static_cast<float>(z);
-    float z1 = static_cast<float>(z + 1);
+    float z1 = static_cast<float>(z + size);
     float b = brightness;
+    float s = static_cast<float>(size);
+
+    pendingMinY = std::min(pendingMinY, y);
+    pendingMaxY = std::max(pendingMaxY, y + size);
 
     if (faceType == "TOP") {
-        float f[] = { x0,y1,z1, 0,1,layer,b, x1,y1,z1, 1,1,layer,b, x1,y1,z0, 1,0,layer,b, x0,y1,z0, 0,0,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x0,y1,z1, 0,s,layer,b, x1,y1,z1, s,s,layer,b, x1,y1,z0, s,0,layer,b, x0,y1,z0, 0,0,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::POS_Y];
+        out.insert(out.end(), f, f + 28);
     }
     else if (faceType == "BOTTOM") {
-        float f[] = { x0,y0,z0, 0,0,layer,b, x1,y0,z0, 1,0,layer,b, x1,y0,z1, 1,1,layer,b, x0,y0,z1, 0,1,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x0,y0,z0, 0,0,layer,b, x1,y0,z0, s,0,layer,b, x1,y0,z1, s,s,layer,b, x0,y0,z1, 0,s,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::NEG_Y];
+        out.insert(out.end(), f, f + 28);
     }
     else if (faceType == "LEFT") {
-        float f[] = { x0,y0,z0, 0,0,layer,b, x0,y0,z1, 1,0,layer,b, x0,y1,z1, 1,1,layer,b, x0,y1,z0, 0,1,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x0,y0,z0, 0,0,layer,b, x0,y0,z1, s,0,layer,b, x0,y1,z1, s,s,layer,b, x0,y1,z0, 0,s,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::NEG_X];
+        out.insert(out.end(), f, f + 28);
     }
     else if (faceType == "RIGHT") {
-        float f[] = { x1,y0,z1, 0,0,layer,b, x1,y0,z0, 1,0,layer,b, x1,y1,z0, 1,1,layer,b, x1,y1,z1, 0,1,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x1,y0,z1, 0,0,layer,b, x1,y0,z0, s,0,layer,b, x1,y1,z0, s,s,layer,b, x1,y1,z1, 0,s,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::POS_X];
+        out.insert(out.end(), f, f + 28);
     }
     else if (faceType == "FRONT") {
-        float f[] = { x0,y0,z1, 0,0,layer,b, x1,y0,z1, 1,0,layer,b, x1,y1,z1, 1,1,layer,b, x0,y1,z1, 0,1,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x0,y0,z1, 0,0,layer,b, x1,y0,z1, s,0,layer,b, x1,y1,z1, s,s,layer,b, x0,y1,z1, 0,s,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::POS_Z];
+        out.insert(out.end(), f, f + 28);
     }
     else if (faceType == "BACK") {
-        float f[] = { x1,y0,z0, 0,0,layer,b, x0,y0,z0, 1,0,layer,b, x0,y1,z0, 1,1,layer,b, x1,y1,z0, 0,1,layer,b };
-        vertices.insert(vertices.end(), f, f + 28);
+        float f[] = { x1,y0,z0, 0,0,layer,b, x0,y0,z0, s,0,layer,b, x0,y1,z0, s,s,layer,b, x1,y1,z0, 0,s,layer,b };
+        std::vector<float>& out = faceBuckets[SectionFace::NEG_Z];
+        out.insert(out.end(), f, f + 28);
     }
-
-    indices.push_back(startIdx + 0);
-    indices.push_back(startIdx + 1);
-    indices.push_back(startIdx + 2);
-    indices.push_back(startIdx + 0);
-    indices.push_back(startIdx + 2);
-    indices.push_back(startIdx + 3);
 }
 
 void Chunk::generateMesh(const ChunkNeighbors& neighbors) {
     vertices.clear();
-    indices.clear();
+    for (auto& bucket : faceBuckets) bucket.clear();
+    pendingMinY = HEIGHT;
+    pendingMaxY = 0;
 
-    // Helper: controlla se il blocco adiacente è aria, anche cross-chunk
-    auto isAir = [&](int x, int y, int z) -> bool {
+    // Helper: controlla se il blocco adiacente lascia vedere la faccia, anche cross-chunk
+    auto isTransparentAt = [&](int x, int y, int z) -> bool {
         if (y < 0 || y >= HEIGHT) return true;
 
         // Dentro il chunk corrente
         if (x >= 0 && x < SIZE && z >= 0 && z < SIZE)
-            return blocks[x][y][z] == BlockType::AIR;
+            return isTransparent(blocks[x][z][y]);
 
         // Cross-boundary: controlla chunk adiacente
         if (x < 0 && neighbors.left)
-            return neighbors.left->blocks[SIZE - 1][y][z] == BlockType::AIR;
+            return isTransparent(neighbors.left->getBlock(SIZE - 1, y, z));
         if (x >= SIZE && neighbors.right)
-            return neighbors.right->blocks[0][y][z] == BlockType::AIR;
+            return isTransparent(neighbors.right->getBlock(0, y, z));
         if (z < 0 && neighbors.back)
-            return neighbors.back->blocks[x][y][SIZE - 1] == BlockType::AIR;
+            return isTransparent(neighbors.back->getBlock(x, y, SIZE - 1));
         if (z >= SIZE && neighbors.front)
-            return neighbors.front->blocks[x][y][0] == BlockType::AIR;
+            return isTransparent(neighbors.front->getBlock(x, y, 0));
 
         // Nessun vicino caricato: renderizza la faccia (sicuro)
         return true;
     };
 
-    for (int x = 0; x < SIZE; x++) {
-        for (int y = 0; y < HEIGHT; y++) {
+    for (auto& row : pendingOccluderHeights)
+        for (unsigned char& height : row) height = HEIGHT;
+
+    if (lod > 0) {
+        generateLodFaces(neighbors, lod);
+    } else {
+        // Colonne y-contigue: sopra heightMap c'è solo aria
+        for (int x = 0; x < SIZE; x++) {
             for (int z = 0; z < SIZE; z++) {
-                unsigned char block = blocks[x][y][z];
-                if (block == BlockType::AIR) continue;
+                const unsigned char* column = blocks[x][z];
+                for (int y = 0; y < heightMap[x][z]; y++) {
+                    unsigned char block = column[y];
+                    if (block == BlockType::AIR) continue;
+
+                    if (isTransparentAt(x, y+1, z)) addFace(x, y, z, "TOP", block);
+                    if (isTransparentAt(x, y-1, z)) addFace(x, y, z, "BOTTOM", block);
+                    if (isTransparentAt(x-1, y, z)) addFace(x, y, z, "LEFT", block);
+                    if (isTransparentAt(x+1, y, z)) addFace(x, y, z, "RIGHT", block);
+                    if (isTransparentAt(x, y, z+1)) addFace(x, y, z, "FRONT", block);
+                    if (isTransparentAt(x, y, z-1)) addFace(x, y, z, "BACK", block);
+                }
 
-                if (isAir(x, y+1, z)) addFace(x, y, z, "TOP", block);
-                if (isAir(x, y-1, z)) addFace(x, y, z, "BOTTOM", block);
-                if (isAir(x-1, y, z)) addFace(x, y, z, "LEFT", block);
-                if (isAir(x+1, y, z)) addFace(x, y, z, "RIGHT", block);
-                if (isAir(x, y, z+1)) addFace(x, y, z, "FRONT", block);
-                if (isAir(x, y, z-1)) addFace(x, y, z, "BACK", block);
+                // Parte piena della colonna: blocchi opachi contigui dal fondo
+                int solid = 0;
+                while (solid < heightMap[x][z] && !isTransparent(column[solid])) solid++;
+                unsigned char& cell = pendingOccluderHeights[x / OCCLUDER_CELL][z / OCCLUDER_CELL];
+                cell = static_cast<unsigned char>(std::min<int>(cell, solid));
             }
         }
     }
+    if (pendingMinY > pendingMaxY) pendingMinY = 0; // Nessuna faccia
+
+    // Bucket contigui nella mesh: il renderer salta quelli rivolti dall'altra parte rispetto alla camera
+    unsigned int quads = 0;
+    for (int face = 0; face < SectionFace::COUNT; face++) {
+        pendingFaceBucketStart[face] = quads;
+        vertices.insert(vertices.end(), faceBuckets[face].begin(), faceBuckets[face].end());
+        quads += static_cast<unsigned int>(faceBuckets[face].size() / 28);
+    }
+    pendingFaceBucketStart[SectionFace::COUNT] = quads;
+
+    // Connettività solo delle sezioni toccate da setBlock dall'ultimo calcolo (tutte dopo generazione/caricamento)
+    unsigned char dirty = dirtySections.exchange(0, std::memory_order_relaxed);
+    for (int s = 0; s < SECTIONS; s++)
+        if (dirty & (1u << s)) pendingConnectivity[s] = computeSectionConnectivity(s);
 }
 
-void Chunk::upload() {
-    if (vertices.empty()) return;
+void Chunk::generateLodFaces(const ChunkNeighbors& neighbors, int level) {
+    const int scale = 1 << level;
+    const int cells = SIZE / scale, cellsY = HEIGHT / scale;
+    const int threshold = scale * scale * scale / 2;
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    // Blocchi ridotti: una cella è piena se almeno metà dei suoi blocchi non è aria, e prende il blocco più alto.
+    // Stessa regola anche sul bordo del chunk: le giunzioni con i vicini si chiudono con quad dedicati (sotto)
+    lodCells.assign(static_cast<size_t>(cells) * cells * cellsY, BlockType::AIR);
+    auto cellAt = [&](int cx, int cy, int cz) -> unsigned char& {
+        return lodCells[(static_cast<size_t>(cx) * cells + cz) * cellsY + cy];
+    };
+    for (int cx = 0; cx < cells; cx++) {
+        for (int cz = 0; cz < cells; cz++) {
+            int top = 0;
+            for (int x = cx * scale; x < (cx + 1) * scale; x++)
+                for (int z = cz * scale; z < (cz + 1) * scale; z++) top = std::max<int>(top, heightMap[x][z]);
+
+            for (int cy = 0; cy * scale < top; cy++) {
+                int filled = 0, highest = -1;
+                unsigned char block = BlockType::AIR;
+                for (int x = cx * scale; x < (cx + 1) * scale; x++) {
+                    for (int z = cz * scale; z < (cz + 1) * scale; z++) {
+                        const unsigned char* column = blocks[x][z];
+                        int yEnd = std::min<int>((cy + 1) * scale, heightMap[x][z]);
+                        for (int y = cy * scale; y < yEnd; y++) {
+                            unsigned char b = column[y];
+                            if (b == BlockType::AIR) continue;
+                            filled++;
+                            if (y > highest) { highest = y; block = b; }
+                        }
+                    }
+                }
+                if (filled >= threshold) cellAt(cx, cy, cz) = block;
+            }
+        }
+    }
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    auto isOpenAt = [&](int cx, int cy, int cz) {
+        return cy < 0 || cy >= cellsY || isTransparent(cellAt(cx, cy, cz));
+    };
+    // Faccia verso un chunk vicino: scartata solo se i blocchi veri dietro di lei sono tutti opachi
+    auto hiddenByNeighbor = [](const Chunk* neighbor, int x0, int x1, int z0, int z1, int y0, int y1) {
+        if (!neighbor) return false;
+        for (int x = x0; x < x1; x++)
+            for (int z = z0; z < z1; z++)
+                for (int y = y0; y < y1; y++)
+                    if (isTransparent(neighbor->getBlock(x, y, z))) return false;
+        return true;
+    };
+
+    for (int cx = 0; cx < cells; cx++) {
+        for (int cz = 0; cz < cells; cz++) {
+            for (int cy = 0; cy < cellsY; cy++) {
+                unsigned char block = cellAt(cx, cy, cz);
+                if (block == BlockType::AIR) continue;
+                int x = cx * scale, y = cy * scale, z = cz * scale;
+
+                if (isOpenAt(cx, cy + 1, cz)) addFace(x, y, z, "TOP", block, scale);
+                if (isOpenAt(cx, cy - 1, cz)) addFace(x, y, z, "BOTTOM", block, scale);
+                if (cx > 0 ? isOpenAt(cx - 1, cy, cz)
+                           : !hiddenByNeighbor(neighbors.left, SIZE - 1, SIZE, z, z + scale, y, y + scale))
+                    addFace(x, y, z, "LEFT", block, scale);
+                if (cx < cells - 1 ? isOpenAt(cx + 1, cy, cz)
+                                   : !hiddenByNeighbor(neighbors.right, 0, 1, z, z + scale, y, y + scale))
+                    addFace(x, y, z, "RIGHT", block, scale);
+                if (cz < cells - 1 ? isOpenAt(cx, cy, cz + 1)
+                                   : !hiddenByNeighbor(neighbors.front, x, x + scale, 0, 1, y, y + scale))
+                    addFace(x, y, z, "FRONT", block, scale);
+                if (cz > 0 ? isOpenAt(cx, cy, cz - 1)
+                           : !hiddenByNeighbor(neighbors.back, x, x + scale, SIZE - 1, SIZE, y, y + scale))
+                    addFace(x, y, z, "BACK", block, scale);
+            }
+        }
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    // Giunzioni con i vicini (a qualunque livello). Dove una cella di bordo è vuota ma il chunk vero ha blocchi
+    // opachi sul bordo, il vicino non ha facce lì: o perché il nostro lato è aperto e lui è vuoto (si vedrebbe
+    // dentro il nostro terreno), o perché lui è pieno e ha scartato la faccia nascosta dal nostro blocco.
+    // Un quad grande quanto la cella sul piano di confine chiude ciascun caso: verso l'esterno nel primo,
+    // verso l'interno (con il blocco del vicino) nel secondo. Nessuna cella viene riempita
+    auto addSeamQuads = [&](const Chunk* neighbor, bool alongX, int edge, const char* outward, const char* inward) {
+        const int neighborEdge = SIZE - 1 - edge, cellEdge = edge / scale;
+        const int outwardAt = cellEdge * scale, inwardAt = edge == 0 ? -scale : SIZE;
+        for (int c = 0; c < cells; c++) {
+            for (int cy = 0; cy < cellsY; cy++) {
+                if (!isTransparent(alongX ? cellAt(c, cy, cellEdge) : cellAt(cellEdge, cy, c))) continue;
+                unsigned char exposed = BlockType::AIR, covered = BlockType::AIR;
+                for (int t = c * scale; t < (c + 1) * scale; t++) {
+                    int x = alongX ? t : edge, z = alongX ? edge : t;
+                    int nx = alongX ? t : neighborEdge, nz = alongX ? neighborEdge : t;
+                    int yEnd = std::min<int>((cy + 1) * scale, heightMap[x][z]);
+                    for (int y = cy * scale; y < yEnd; y++) {
+                        unsigned char own = blocks[x][z][y];
+                        if (isTransparent(own)) continue;
+                        unsigned char other = neighbor ? neighbor->getBlock(nx, y, nz) : BlockType::AIR;
+                        if (isTransparent(other)) exposed = own;
+                        else covered = other;
+                    }
+                }
+                int along = c * scale, y = cy * scale;
+                if (exposed != BlockType::AIR)
+                    addFace(alongX ? along : outwardAt, y, alongX ? outwardAt : along, outward, exposed, scale);
+                if (covered != BlockType::AIR)
+                    addFace(alongX ? along : inwardAt, y, alongX ? inwardAt : along, inward, covered, scale);
+            }
+        }
+    };
+    addSeamQuads(neighbors.left, false, 0, "LEFT", "RIGHT");
+    addSeamQuads(neighbors.right, false, SIZE - 1, "RIGHT", "LEFT");
+    addSeamQuads(neighbors.back, true, 0, "BACK", "FRONT");
+    addSeamQuads(neighbors.front, true, SIZE - 1, "FRONT", "BACK");
 
-    int stride = 7 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // Occluder dalle celle ridotte, non dai blocchi: devono stare dentro la geometria che viene davvero disegnata
+    for (int x = 0; x < SIZE; x++) {
+        for (int z = 0; z < SIZE; z++) {
+            int solid = 0;
+            while (solid < cellsY && !isTransparent(cellAt(x / scale, solid, z / scale))) solid++;
+            unsigned char& cell = pendingOccluderHeights[x / OCCLUDER_CELL][z / OCCLUDER_CELL];
+            cell = static_cast<unsigned char>(std::min<int>(cell, solid * scale));
+        }
+    }
+}
 
+void Chunk::upload(ChunkMeshArena& target) {
+    // Con un intervallo già assegnato l'arena lo riusa se la nuova mesh ci sta
+    if (!target.upload(vertices, mesh)) {
+        releaseMesh(); // Mesh vuota (es. chunk svuotato dal giocatore)
+        return;
+    }
+    arena = &target;
     isUploaded = true;
-    indexCount = static_cast<unsigned int>(indices.size());
+    std::memcpy(occluderHeights, pendingOccluderHeights, sizeof(occluderHeights));
+    meshMinY = pendingMinY;
+    meshMaxY = pendingMaxY;
+    std::memcpy(sectionConnectivity, pendingConnectivity, sizeof(sectionConnectivity));
+    std::memcpy(faceBucketStart, pendingFaceBucketStart, sizeof(faceBucketStart));
 
     vertices.clear();
-    indices.clear();
     vertices.shrink_to_fit();
-    indices.shrink_to_fit();
 }
 
-void Chunk::rebuild(const ChunkNeighbors& neighbors) {
-    if (isUploaded) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-        isUploaded = false;
-    }
-
+void Chunk::rebuild(ChunkMeshArena& target, const ChunkNeighbors& neighbors) {
     generateMesh(neighbors);
-    upload();
+    upload(target);
 }
 
 void Chunk::rebuildMeshOnly(const ChunkNeighbors& neighbors) {
@@ -208,36 +504,157 @@ void Chunk::rebuildMeshOnly(const ChunkNeighbors& neighbors) {
     needsReupload = true;
 }
 
-void Chunk::reupload() {
-    if (isUploaded) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
-        isUploaded = false;
-    }
-    upload();
+void Chunk::reupload(ChunkMeshArena& target) {
+    upload(target);
     needsReupload = false;
 }
 
-void Chunk::render() const {
+int Chunk::visibleFaceRanges(const glm::vec3& eye, unsigned int firstQuad[3], unsigned int quadCount[3]) const {
+    // Una faccia -X sul piano x è visibile solo da x minori: se la camera sta oltre il bordo +X del chunk
+    // nessuna faccia -X è rivolta verso di lei (e così per ogni direzione, con il box della mesh)
+    float minX = static_cast<float>(chunkX * SIZE), maxX = minX + SIZE;
+    float minZ = static_cast<float>(chunkZ * SIZE), maxZ = minZ + SIZE;
+    bool facing[SectionFace::COUNT] = {
+        eye.x < maxX, eye.x > minX,
+        eye.y < meshMaxY, eye.y > meshMinY,
+        eye.z < maxZ, eye.z > minZ
+    };
+
+    // Bucket adiacenti visibili uniti in un solo intervallo: con una faccia per coppia al più 3 intervalli
+    int ranges = 0;
+    for (int face = 0; face < SectionFace::COUNT; face++) {
+        unsigned int start = faceBucketStart[face], end = faceBucketStart[face + 1];
+        if (!facing[face] || start == end) continue;
+        if (ranges > 0 && firstQuad[ranges - 1] + quadCount[ranges - 1] == start) {
+            quadCount[ranges - 1] += end - start;
+        } else if (ranges < 3) {
+            firstQuad[ranges] = start;
+            quadCount[ranges] = end - start;
+            ranges++;
+        } else {
+            // Non capita con bucket ordinati a coppie; per sicurezza estende l'ultimo intervallo
+            quadCount[ranges - 1] = end - firstQuad[ranges - 1];
+        }
+    }
+    return ranges;
+}
+
+void Chunk::render(const glm::vec3& eye) const {
     if (!isUploaded) return;
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    unsigned int firstQuad[3], quadCount[3];
+    int ranges = visibleFaceRanges(eye, firstQuad, quadCount);
+    if (ranges > 0) arena->draw(mesh, firstQuad, quadCount, ranges);
+}
+
+std::string Chunk::filePath(const std::string& worldDir, int cx, int cz) {
+    return worldDir + "/chunk_" + std::to_string(cx) + "_" + std::to_string(cz) + ".bin";
+}
+
+namespace {
+    // Formato su disco: magic, spillReceived (2 byte little endian), poi per colonna (x, poi z)
+    // numero di run e coppie {blocco, lunghezza}. MCR1: stesso formato senza spillReceived
+    const char CHUNK_FILE_MAGIC[4] = { 'M', 'C', 'R', '2' };
+    const char CHUNK_FILE_MAGIC_V1[4] = { 'M', 'C', 'R', '1' };
 }
 
 bool Chunk::saveToFile(const std::string& worldDir) const {
+    // Run di colonna: riusati da generazione/caricamento, ricalcolati solo per le colonne modificate
+    std::vector<unsigned char> data(CHUNK_FILE_MAGIC, CHUNK_FILE_MAGIC + 4);
+    data.reserve(6 + SIZE * SIZE * 12);
+    data.push_back(static_cast<unsigned char>(spillReceived & 0xFF));
+    data.push_back(static_cast<unsigned char>(spillReceived >> 8));
+    std::vector<BlockRun> scratch;
+    for (int x = 0; x < SIZE; x++) {
+        for (int z = 0; z < SIZE; z++) {
+            const int c = x * SIZE + z;
+            const BlockRun* runs;
+            size_t count;
+            if (dirtyColumns.test(c) || columnRuns.empty()) {
+                scratch.clear();
+                encodeColumn(x, z, scratch);
+                runs = scratch.data();
+                count = scratch.size();
+            } else {
+                runs = columnRuns.data() + runOffset[c];
+                count = runOffset[c + 1] - runOffset[c];
+            }
+            data.push_back(static_cast<unsigned char>(count));
+            for (size_t r = 0; r < count; r++) {
+                data.push_back(runs[r].block);
+                data.push_back(runs[r].length);
+            }
+        }
+    }
+
     std::filesystem::create_directories(worldDir);
-    std::string path = worldDir + "/chunk_" + std::to_string(chunkX) + "_" + std::to_string(chunkZ) + ".bin";
-    std::ofstream file(path, std::ios::binary);
-    if (!file.is_open()) return false;
-    file.write(reinterpret_cast<const char*>(blocks), sizeof(blocks));
-    return file.good();
+    // Scrive su file temporaneo e rinomina: un salvataggio interrotto non lascia chunk troncati
+    std::string path = filePath(worldDir, chunkX, chunkZ);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        if (!file.is_open()) return false;
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    return !ec;
 }
 
 bool Chunk::loadFromFile(const std::string& worldDir) {
-    std::string path = worldDir + "/chunk_" + std::to_string(chunkX) + "_" + std::to_string(chunkZ) + ".bin";
-    std::ifstream file(path, std::ios::binary);
+    std::ifstream file(filePath(worldDir, chunkX, chunkZ), std::ios::binary);
     if (!file.is_open()) return false;
-    file.read(reinterpret_cast<char*>(blocks), sizeof(blocks));
-    return file.good();
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Prima il magic: un file RLE può avere per caso la stessa dimensione del dump grezzo.
+    // Il legacy non può iniziare con il magic ('M' = 77 non è un blocco valido)
+    bool isV2 = data.size() >= 6 && std::equal(CHUNK_FILE_MAGIC, CHUNK_FILE_MAGIC + 4, data.begin());
+    bool isV1 = data.size() >= 4 && std::equal(CHUNK_FILE_MAGIC_V1, CHUNK_FILE_MAGIC_V1 + 4, data.begin());
+    bool hasMagic = isV1 || isV2;
+
+    // Formato legacy: dump grezzo di blocks[x][y][z]
+    if (!hasMagic && data.size() == static_cast<size_t>(SIZE * HEIGHT * SIZE)) {
+        for (int x = 0; x < SIZE; x++)
+            for (int y = 0; y < HEIGHT; y++)
+                for (int z = 0; z < SIZE; z++)
+                    blocks[x][z][y] = data[(x * HEIGHT + y) * SIZE + z];
+        columnRuns.clear();
+        for (int c = 0; c < SIZE * SIZE; c++) {
+            runOffset[c] = static_cast<unsigned short>(columnRuns.size());
+            encodeColumn(c / SIZE, c % SIZE, columnRuns);
+        }
+        runOffset[SIZE * SIZE] = static_cast<unsigned short>(columnRuns.size());
+        applyColumnRuns(false);
+        spillReceived = ALL_SPILL_RECEIVED; // Salvataggi vecchi: le chiome presenti sono già nel file
+        return true;
+    }
+
+    if (!hasMagic) return false;
+
+    size_t pos = 4;
+    uint16_t spill = ALL_SPILL_RECEIVED;
+    if (isV2) {
+        spill = static_cast<uint16_t>(data[4] | (data[5] << 8));
+        pos = 6;
+    }
+    columnRuns.clear();
+    for (int c = 0; c < SIZE * SIZE; c++) {
+        if (pos >= data.size()) return false;
+        size_t count = data[pos++];
+        if (pos + count * 2 > data.size()) return false;
+        runOffset[c] = static_cast<unsigned short>(columnRuns.size());
+        int total = 0;
+        for (size_t r = 0; r < count; r++) {
+            BlockRun run{ data[pos], data[pos + 1] };
+            pos += 2;
+            if (run.block >= BlockType::COUNT || run.length == 0) return false;
+            total += run.length;
+            columnRuns.push_back(run);
+        }
+        if (total != HEIGHT) return false;
+    }
+    runOffset[SIZE * SIZE] = static_cast<unsigned short>(columnRuns.size());
+    applyColumnRuns(true);
+    spillReceived = spill;
+    return true;
 }
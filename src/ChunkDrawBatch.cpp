@@ -0,0 +1,59 @@
+#include "ChunkDrawBatch.hpp"
+#include "Chunk.hpp"
+#include "GLHeaders.hpp"
+#include <GLFW/glfw3.h>
+
+// Assenti dall'header di macOS (fermo a 4.1)
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+ChunkDrawBatch::~ChunkDrawBatch() {
+    if (commandBuffer) {
+        glDeleteBuffers(1, &commandBuffer);
+        glDeleteBuffers(1, &offsetBuffer);
+    }
+}
+
+bool ChunkDrawBatch::init(ChunkMeshArena& arena) {
+    int major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major < 4 || (major == 4 && minor < 3)) return false;
+
+    multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectFn>(
+        glfwGetProcAddress("glMultiDrawElementsIndirect"));
+    if (!multiDrawElementsIndirect) return false;
+
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &offsetBuffer);
+    arena.attachInstanceOffsets(offsetBuffer);
+    return true;
+}
+
+void ChunkDrawBatch::clear() {
+    commands.clear();
+    offsets.clear();
+}
+
+void ChunkDrawBatch::add(const MeshAllocation& mesh, const unsigned int* firstQuads, const unsigned int* quadCounts, int ranges,
+                         int chunkX, int chunkZ) {
+    if (ranges == 0) return;
+    unsigned int instance = static_cast<unsigned int>(offsets.size() / 2);
+    for (int i = 0; i < ranges; i++)
+        commands.push_back({ quadCounts[i] * 6, 1, firstQuads[i] * 6, static_cast<int>(mesh.vertexOffset), instance });
+    offsets.push_back(static_cast<float>(chunkX * Chunk::SIZE));
+    offsets.push_back(static_cast<float>(chunkZ * Chunk::SIZE));
+}
+
+void ChunkDrawBatch::submit() {
+    if (commands.empty()) return;
+
+    // Buffer riallocati ogni frame (orphaning): il driver non aspetta i draw del frame precedente
+    glBindBuffer(GL_ARRAY_BUFFER, offsetBuffer);
+    glBufferData(GL_ARRAY_BUFFER, offsets.size() * sizeof(float), offsets.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand), commands.data(), GL_STREAM_DRAW);
+
+    multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<int>(commands.size()), 0);
+}
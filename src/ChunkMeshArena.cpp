@@ -0,0 +1,235 @@
+#include "ChunkMeshArena.hpp"
+#include "GLHeaders.hpp"
+#include <algorithm>
+
+namespace {
+    size_t roundUp(size_t count, size_t granularity) {
+        return (count + granularity - 1) / granularity * granularity;
+    }
+
+    // Nuovo buffer di `newBytes` con i primi `oldBytes` copiati lato GPU; il vecchio viene eliminato
+    unsigned int reallocateBuffer(unsigned int oldBuffer, size_t oldBytes, size_t newBytes) {
+        unsigned int buffer;
+        glGenBuffers(1, &buffer);
+        // Target di copia: non toccano il VAO né i binding usati per disegnare
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_DYNAMIC_DRAW);
+        if (oldBuffer) {
+            glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+            glDeleteBuffers(1, &oldBuffer);
+        }
+        return buffer;
+    }
+}
+
+// --- RangeAllocator ---
+
+RangeAllocator::RangeAllocator(size_t capacity) : total(capacity) {
+    if (capacity > 0) freeList.push_back({0, capacity});
+}
+
+bool RangeAllocator::allocate(size_t count, size_t& offset) {
+    for (size_t i = 0; i < freeList.size(); i++) {
+        Range& range = freeList[i];
+        if (range.count < count) continue;
+        offset = range.offset;
+        range.offset += count;
+        range.count -= count;
+        if (range.count == 0) freeList.erase(freeList.begin() + i);
+        usedCount += count;
+        return true;
+    }
+    return false;
+}
+
+void RangeAllocator::free(size_t offset, size_t count) {
+    auto it = std::lower_bound(freeList.begin(), freeList.end(), offset,
+                               [](const Range& range, size_t value) { return range.offset < value; });
+    it = freeList.insert(it, {offset, count});
+    usedCount -= count;
+
+    // Fonde con il successivo e poi con il precedente
+    auto next = it + 1;
+    if (next != freeList.end() && it->offset + it->count == next->offset) {
+        it->count += next->count;
+        it = freeList.erase(next) - 1;
+    }
+    if (it != freeList.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->count == it->offset) {
+            prev->count += it->count;
+            freeList.erase(it);
+        }
+    }
+}
+
+void RangeAllocator::grow(size_t newCapacity) {
+    if (newCapacity <= total) return;
+    if (!freeList.empty() && freeList.back().offset + freeList.back().count == total)
+        freeList.back().count += newCapacity - total;
+    else
+        freeList.push_back({total, newCapacity - total});
+    total = newCapacity;
+}
+
+size_t RangeAllocator::largestFree() const {
+    size_t largest = 0;
+    for (const Range& range : freeList) largest = std::max(largest, range.count);
+    return largest;
+}
+
+// --- ChunkMeshArena ---
+
+ChunkMeshArena::ChunkMeshArena(size_t vertexCapacity, size_t quadCapacity)
+    : vertexRanges(vertexCapacity), quadCapacity(quadCapacity) {
+}
+
+ChunkMeshArena::~ChunkMeshArena() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+}
+
+void ChunkMeshArena::createBuffers() {
+    glGenVertexArrays(1, &VAO);
+    VBO = reallocateBuffer(0, 0, vertexRanges.capacity() * VERTEX_FLOATS * sizeof(float));
+    glGenBuffers(1, &EBO);
+    fillQuadIndices();
+    setupVertexAttributes();
+}
+
+void ChunkMeshArena::fillQuadIndices() {
+    std::vector<unsigned int> indices(quadCapacity * 6);
+    for (size_t quad = 0; quad < quadCapacity; quad++) {
+        unsigned int first = static_cast<unsigned int>(quad * 4);
+        unsigned int* out = &indices[quad * 6];
+        out[0] = first + 0; out[1] = first + 1; out[2] = first + 2;
+        out[3] = first + 0; out[4] = first + 2; out[5] = first + 3;
+    }
+    // Stesso nome del buffer: il VAO resta valido anche quando lo si ridimensiona
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+}
+
+void ChunkMeshArena::setupVertexAttributes() const {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    int stride = VERTEX_FLOATS * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    if (instanceBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+    }
+}
+
+void ChunkMeshArena::attachInstanceOffsets(unsigned int buffer) {
+    instanceBuffer = buffer;
+    if (!VAO) createBuffers();
+    else setupVertexAttributes();
+}
+
+void ChunkMeshArena::growVertices(size_t minCapacity) {
+    size_t oldCapacity = vertexRanges.capacity();
+    size_t newCapacity = std::max(oldCapacity * 2, minCapacity);
+    VBO = reallocateBuffer(VBO, oldCapacity * VERTEX_FLOATS * sizeof(float), newCapacity * VERTEX_FLOATS * sizeof(float));
+    vertexRanges.grow(newCapacity);
+    setupVertexAttributes(); // I puntatori agli attributi si riferiscono al buffer vecchio
+    growths++;
+}
+
+bool ChunkMeshArena::upload(const std::vector<float>& vertices, MeshAllocation& out) {
+    if (vertices.empty()) return false;
+    if (!VAO) createBuffers();
+
+    size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    size_t quads = vertexCount / 4;
+
+    // Mesh più grande di quelle viste finora: il buffer di indici condiviso raddoppia fino a coprirla
+    if (quads > quadCapacity) {
+        while (quadCapacity < quads) quadCapacity *= 2;
+        fillQuadIndices();
+    }
+
+    if (out.vertexCount > 0) {
+        if (vertexCount <= out.vertexCount) {
+            inPlaceUpdates++;
+        } else {
+            // Non ci sta: nuovo intervallo con margine (crescita geometrica)
+            release(out);
+            size_t vertexSlots = roundUp(vertexCount * GROWTH_NUM / GROWTH_DEN, GRANULARITY);
+            out.vertexOffset = static_cast<unsigned int>(allocateVertices(vertexSlots));
+            out.vertexCount = static_cast<unsigned int>(vertexSlots);
+            reallocations++;
+        }
+    } else {
+        size_t vertexSlots = roundUp(vertexCount, GRANULARITY);
+        out.vertexOffset = static_cast<unsigned int>(allocateVertices(vertexSlots));
+        out.vertexCount = static_cast<unsigned int>(vertexSlots);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, out.vertexOffset * VERTEX_FLOATS * sizeof(float),
+                    vertices.size() * sizeof(float), vertices.data());
+    out.indexCount = static_cast<unsigned int>(quads * 6);
+    return true;
+}
+
+size_t ChunkMeshArena::allocateVertices(size_t slots) {
+    size_t offset;
+    while (!vertexRanges.allocate(slots, offset))
+        growVertices(vertexRanges.capacity() + slots);
+    return offset;
+}
+
+void ChunkMeshArena::release(MeshAllocation& allocation) {
+    vertexRanges.free(allocation.vertexOffset, allocation.vertexCount);
+    allocation = {};
+}
+
+void ChunkMeshArena::bind() const {
+    glBindVertexArray(VAO);
+}
+
+void ChunkMeshArena::draw(const MeshAllocation& allocation, const unsigned int* firstQuads, const unsigned int* quadCounts, int ranges) const {
+    // Il quad q usa gli indici [6q, 6q+6) del buffer condiviso (che puntano ai vertici 4q..4q+3):
+    // il base vertex sposta tutto nell'intervallo del chunk
+    constexpr int MAX_RANGES = 8;
+    GLsizei counts[MAX_RANGES];
+    const void* offsets[MAX_RANGES];
+    GLint baseVertices[MAX_RANGES];
+    ranges = std::min(ranges, MAX_RANGES);
+    for (int i = 0; i < ranges; i++) {
+        counts[i] = static_cast<GLsizei>(quadCounts[i] * 6);
+        offsets[i] = (void*)(static_cast<size_t>(firstQuads[i]) * 6 * sizeof(unsigned int));
+        baseVertices[i] = static_cast<GLint>(allocation.vertexOffset);
+    }
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts, GL_UNSIGNED_INT, offsets, ranges, baseVertices);
+}
+
+ChunkMeshArena::Stats ChunkMeshArena::stats() const {
+    size_t freeCount = vertexRanges.capacity() - vertexRanges.used();
+    float fragmentation = freeCount == 0 ? 0.0f
+        : 1.0f - static_cast<float>(vertexRanges.largestFree()) / static_cast<float>(freeCount);
+    return {
+        vertexRanges.capacity(), vertexRanges.used(),
+        quadCapacity,
+        vertexRanges.freeBlocks(),
+        fragmentation,
+        growths,
+        inPlaceUpdates,
+        reallocations
+    };
+}
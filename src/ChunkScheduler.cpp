@@ -0,0 +1,112 @@
+#include "ChunkScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Soglia di rotazione oltre cui il frustum cambia abbastanza da rivalutare (~15 gradi)
+    constexpr float REEVALUATE_DOT = 0.966f;
+
+    bool lowerPriority(const ChunkJob* a, const ChunkJob* b) {
+        return a->priority > b->priority;
+    }
+}
+
+float ChunkScheduler::computePriority(const ChunkJob& job) const {
+    float dx = static_cast<float>(job.chunkX - cameraChunkX);
+    float dz = static_cast<float>(job.chunkZ - cameraChunkZ);
+    float distSq = dx * dx + dz * dz;
+
+    glm::vec3 min(job.chunkX * Chunk::SIZE, 0, job.chunkZ * Chunk::SIZE);
+    glm::vec3 max((job.chunkX + 1) * Chunk::SIZE, Chunk::HEIGHT, (job.chunkZ + 1) * Chunk::SIZE);
+    bool visible = !hasCamera || frustum.isBoxVisible(min, max);
+
+    // Fasce separate: classe (1e6) > frustum (1e5) > distanza al quadrato (in chunk)
+    return static_cast<float>(job.kind) * 1e6f + (visible ? 0.0f : 1e5f) + distSq;
+}
+
+ChunkJob* ChunkScheduler::acquire() {
+    if (freeRecords.empty()) {
+        records.push_back(std::make_unique<ChunkJob>());
+        return records.back().get();
+    }
+    ChunkJob* job = freeRecords.back();
+    freeRecords.pop_back();
+    return job;
+}
+
+void ChunkScheduler::release(ChunkJob* job) {
+    // clear() mantiene la capacità; i riferimenti ai chunk si rilasciano qui, sul thread principale
+    job->chunks.clear();
+    job->meshNeighbors.clear();
+    job->neighbors.clear();
+    job->waiter = nullptr;
+    job->dropped = false;
+    job->running = false;
+    freeRecords.push_back(job);
+}
+
+void ChunkScheduler::rebuildHeap() {
+    for (ChunkJob* job : jobs) job->priority = computePriority(*job);
+    std::make_heap(jobs.begin(), jobs.end(), lowerPriority);
+}
+
+void ChunkScheduler::enqueue(ChunkJob* job) {
+    job->priority = computePriority(*job);
+    jobs.push_back(job);
+    std::push_heap(jobs.begin(), jobs.end(), lowerPriority);
+}
+
+bool ChunkScheduler::promote(ChunkJob* job, ChunkJobKind kind) {
+    if (std::find(jobs.begin(), jobs.end(), job) == jobs.end()) return false;
+    if (kind < job->kind) {
+        job->kind = kind;
+        job->priority = computePriority(*job);
+        std::make_heap(jobs.begin(), jobs.end(), lowerPriority);
+    }
+    return true;
+}
+
+void ChunkScheduler::updateCamera(const Camera& camera) {
+    int chunkX = static_cast<int>(std::floor(camera.Position.x / Chunk::SIZE));
+    int chunkZ = static_cast<int>(std::floor(camera.Position.z / Chunk::SIZE));
+    bool moved = !hasCamera || chunkX != cameraChunkX || chunkZ != cameraChunkZ
+              || glm::dot(camera.Front, cameraFront) < REEVALUATE_DOT;
+
+    frustum = camera.frustum;
+    if (!moved) return;
+
+    cameraChunkX = chunkX;
+    cameraChunkZ = chunkZ;
+    cameraFront = camera.Front;
+    hasCamera = true;
+    rebuildHeap();
+}
+
+const std::vector<ChunkJob*>& ChunkScheduler::takeReady(size_t slots) {
+    ready.clear();
+    while (!jobs.empty()) {
+        bool isEdit = jobs.front()->kind == ChunkJobKind::EDIT_REMESH;
+        if (!isEdit && slots == 0) break;
+        std::pop_heap(jobs.begin(), jobs.end(), lowerPriority);
+        ready.push_back(jobs.back());
+        jobs.pop_back();
+        if (!isEdit) slots--;
+    }
+    return ready;
+}
+
+const std::vector<ChunkJob*>& ChunkScheduler::takeCancelled() {
+    cancelled.clear();
+    auto it = std::remove_if(jobs.begin(), jobs.end(), [this](ChunkJob* job) {
+        for (const auto& chunk : job->chunks)
+            if (!chunk->cancelled.load(std::memory_order_relaxed)) return false;
+        job->dropped = true;
+        cancelled.push_back(job);
+        return true;
+    });
+    if (it != jobs.end()) {
+        jobs.erase(it, jobs.end());
+        std::make_heap(jobs.begin(), jobs.end(), lowerPriority);
+    }
+    return cancelled;
+}
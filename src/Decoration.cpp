@@ -0,0 +1,218 @@
+#include "Decoration.hpp"
+#include "Biome.hpp"
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+    unsigned int columnHash(int worldX, int worldZ, int seed, unsigned int salt) {
+        unsigned int h = static_cast<unsigned int>(worldX) * 0x8da6b343u
+                       ^ static_cast<unsigned int>(worldZ) * 0xd8163841u
+                       ^ (static_cast<unsigned int>(seed) + salt) * 0xcb1ab31fu;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        return h;
+    }
+
+    bool isLog(unsigned char block) {
+        return block == BlockType::OAK_LOG || block == BlockType::SPRUCE_LOG;
+    }
+
+    bool isLeaves(unsigned char block) {
+        return block == BlockType::OAK_LEAVES || block == BlockType::SPRUCE_LEAVES;
+    }
+
+    // Priorità di sovrascrittura: aria < foglie < tronchi < terreno.
+    // Vince sempre il massimo, quindi il risultato non dipende dall'ordine di arrivo delle scritture.
+    int writeRank(unsigned char block) {
+        int cls = 3;
+        if (block == BlockType::AIR) cls = 0;
+        else if (isLeaves(block)) cls = 1;
+        else if (isLog(block)) cls = 2;
+        return (cls << 8) | block;
+    }
+
+    bool writeBlock(Chunk& chunk, int x, int y, int z, unsigned char block) {
+        unsigned char target = chunk.getBlock(x, y, z);
+        if (writeRank(target) >= 3 << 8 || writeRank(block) <= writeRank(target)) return false;
+        chunk.setBlock(x, y, z, block);
+        return true;
+    }
+
+    // Raccoglie le scritture di un albero: dirette nel chunk o accodate per i vicini
+    struct TreeWriter {
+        Chunk& chunk;
+        bool writeSelf;
+        long long onlyTarget;
+        std::unordered_map<long long, std::vector<PendingBlock>> spill;
+
+        void set(int x, int y, int z, unsigned char block) {
+            if (y < 0 || y >= Chunk::HEIGHT) return;
+            if (x >= 0 && x < Chunk::SIZE && z >= 0 && z < Chunk::SIZE) {
+                if (writeSelf) writeBlock(chunk, x, y, z, block);
+                return;
+            }
+            int worldX = chunk.chunkX * Chunk::SIZE + x;
+            int worldZ = chunk.chunkZ * Chunk::SIZE + z;
+            int targetX = worldX >> 4, targetZ = worldZ >> 4;
+            long long key = chunkHash(targetX, targetZ);
+            if (onlyTarget != NO_TARGET && key != onlyTarget) return;
+            // Questo chunk visto dal destinatario
+            int source = (chunk.chunkX - targetX + 1) * 3 + (chunk.chunkZ - targetZ + 1);
+            spill[key].push_back({ static_cast<unsigned char>(worldX & 15), static_cast<unsigned char>(y),
+                                   static_cast<unsigned char>(worldZ & 15), block, static_cast<unsigned char>(source) });
+        }
+    };
+
+    void placeOak(TreeWriter& w, int x, int ground, int z, unsigned int rnd) {
+        int trunk = 4 + static_cast<int>(rnd % 3);
+        int top = ground + trunk;
+
+        for (int y = top - 2; y <= top - 1; y++) {
+            for (int dx = -2; dx <= 2; dx++) {
+                for (int dz = -2; dz <= 2; dz++) {
+                    // Angoli del livello largo tagliati a caso
+                    if (abs(dx) == 2 && abs(dz) == 2 && ((rnd >> (8 + (y - top + 2) * 4 + (dx > 0) * 2 + (dz > 0))) & 1)) continue;
+                    w.set(x + dx, y, z + dz, BlockType::OAK_LEAVES);
+                }
+            }
+        }
+        for (int dx = -1; dx <= 1; dx++)
+            for (int dz = -1; dz <= 1; dz++)
+                w.set(x + dx, top, z + dz, BlockType::OAK_LEAVES);
+        w.set(x, top + 1, z, BlockType::OAK_LEAVES);
+        w.set(x - 1, top + 1, z, BlockType::OAK_LEAVES);
+        w.set(x + 1, top + 1, z, BlockType::OAK_LEAVES);
+        w.set(x, top + 1, z - 1, BlockType::OAK_LEAVES);
+        w.set(x, top + 1, z + 1, BlockType::OAK_LEAVES);
+
+        for (int y = ground + 1; y <= top; y++)
+            w.set(x, y, z, BlockType::OAK_LOG);
+    }
+
+    void placeSpruce(TreeWriter& w, int x, int ground, int z, unsigned int rnd) {
+        int trunk = 6 + static_cast<int>(rnd % 3);
+        int top = ground + trunk;
+
+        // Cono: raggio alternato 1/2 scendendo dalla cima
+        w.set(x, top + 1, z, BlockType::SPRUCE_LEAVES);
+        int radius = 1;
+        for (int y = top; y >= ground + 3; y--) {
+            for (int dx = -radius; dx <= radius; dx++) {
+                for (int dz = -radius; dz <= radius; dz++) {
+                    if (radius == 2 && abs(dx) == 2 && abs(dz) == 2) continue;
+                    w.set(x + dx, y, z + dz, BlockType::SPRUCE_LEAVES);
+                }
+            }
+            radius = (radius == 1) ? 2 : 1;
+        }
+
+        for (int y = ground + 1; y <= top; y++)
+            w.set(x, y, z, BlockType::SPRUCE_LOG);
+    }
+}
+
+void PendingBlockStore::push(long long key, const std::vector<PendingBlock>& writes) {
+    if (writes.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& queue = queues[key];
+    if (queue.empty()) dirtyKeys.push_back(key);
+    queue.insert(queue.end(), writes.begin(), writes.end());
+}
+
+bool PendingBlockStore::take(long long key, std::vector<PendingBlock>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = queues.find(key);
+    if (it == queues.end()) return false;
+    out = std::move(it->second);
+    queues.erase(it);
+    return true;
+}
+
+std::vector<long long> PendingBlockStore::takeDirtyKeys() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<long long> keys;
+    keys.swap(dirtyKeys);
+    return keys;
+}
+
+std::vector<long long> PendingBlockStore::keys() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<long long> result;
+    result.reserve(queues.size());
+    for (const auto& entry : queues) result.push_back(entry.first);
+    return result;
+}
+
+void PendingBlockStore::pruneOutside(int centerX, int centerZ, int radius) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = queues.begin(); it != queues.end(); ) {
+        int cx = static_cast<int>(it->first >> 32);
+        int cz = static_cast<int>(static_cast<unsigned int>(it->first));
+        if (abs(cx - centerX) > radius || abs(cz - centerZ) > radius)
+            it = queues.erase(it);
+        else
+            ++it;
+    }
+}
+
+size_t PendingBlockStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queues.size();
+}
+
+void decorateChunk(Chunk& chunk, PendingBlockStore& pending, bool writeSelf, long long onlyTarget, int seed) {
+    // Il bioma per colonna decide tipo e densità degli alberi (stesso campionamento del terreno)
+    BiomeMap biomeMap(seed);
+    ColumnBiome columns[Chunk::SIZE][Chunk::SIZE];
+    biomeMap.sampleChunk(chunk.chunkX, chunk.chunkZ, columns);
+
+    TreeWriter writer{ chunk, writeSelf, onlyTarget, {} };
+
+    for (int x = 0; x < Chunk::SIZE; x++) {
+        for (int z = 0; z < Chunk::SIZE; z++) {
+            // Senza scritture interne servono solo gli alberi abbastanza vicini al bordo da sconfinare
+            if (!writeSelf && x >= 2 && x < Chunk::SIZE - 2 && z >= 2 && z < Chunk::SIZE - 2) continue;
+
+            const BiomeParams& biome = getBiomeParams(columns[x][z].biome);
+            if (biome.tree == TreeType::NONE) continue;
+
+            int worldX = chunk.chunkX * Chunk::SIZE + x;
+            int worldZ = chunk.chunkZ * Chunk::SIZE + z;
+            unsigned int rnd = columnHash(worldX, worldZ, seed, 0x7265u);
+            if (static_cast<float>(rnd & 0xFFFFu) / 65536.0f >= biome.treeChance) continue;
+
+            // Suolo: primo blocco sotto eventuali chiome/tronchi già presenti
+            int ground = std::max(0, chunk.heightMap[x][z] - 1);
+            while (ground > 0) {
+                unsigned char b = chunk.getBlock(x, ground, z);
+                if (b != BlockType::AIR && !isLeaves(b) && !isLog(b)) break;
+                ground--;
+            }
+            if (chunk.getBlock(x, ground, z) != biome.top) continue;
+            if (ground + 11 >= Chunk::HEIGHT) continue;
+
+            if (biome.tree == TreeType::OAK) placeOak(writer, x, ground, z, rnd >> 16);
+            else placeSpruce(writer, x, ground, z, rnd >> 16);
+        }
+    }
+
+    for (auto& [key, writes] : writer.spill)
+        pending.push(key, writes);
+}
+
+bool applyPendingBlocks(Chunk& chunk, PendingBlockStore& pending) {
+    std::vector<PendingBlock> writes;
+    if (!pending.take(chunkHash(chunk.chunkX, chunk.chunkZ), writes)) return false;
+
+    // Copie doppie dello stesso vicino nella stessa coda (es. riemesse) si applicano tutte: le scritture sono idempotenti
+    bool changed = false;
+    uint16_t delivered = 0;
+    for (const PendingBlock& w : writes) {
+        if (chunk.spillReceived & (1u << w.source)) continue;
+        changed |= writeBlock(chunk, w.x, w.y, w.z, w.block);
+        delivered |= static_cast<uint16_t>(1u << w.source);
+    }
+    chunk.spillReceived |= delivered;
+    return changed;
+}
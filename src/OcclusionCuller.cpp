@@ -0,0 +1,255 @@
+#include "OcclusionCuller.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // 4 float per volta: NEON su Apple Silicon, SSE2 su x86, scalare altrove.
+    // Maschere: lane a tutti 1 dove il confronto è vero
+#if defined(__ARM_NEON)
+    using Float4 = float32x4_t;
+    using Mask4 = uint32x4_t;
+    inline Float4 splat4(float v) { return vdupq_n_f32(v); }
+    inline Float4 load4(const float* p) { return vld1q_f32(p); }
+    inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+    inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    inline Mask4 greaterEqual4(Float4 a, Float4 b) { return vcgeq_f32(a, b); }
+    inline Mask4 greater4(Float4 a, Float4 b) { return vcgtq_f32(a, b); }
+    inline Mask4 and4(Mask4 a, Mask4 b) { return vandq_u32(a, b); }
+    inline Float4 select4(Mask4 m, Float4 a, Float4 b) { return vbslq_f32(m, a, b); }
+    inline bool any4(Mask4 m) { return vmaxvq_u32(m) != 0; }
+#elif defined(__SSE2__)
+    using Float4 = __m128;
+    using Mask4 = __m128;
+    inline Float4 splat4(float v) { return _mm_set1_ps(v); }
+    inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+    inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+    inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Mask4 greaterEqual4(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+    inline Mask4 greater4(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+    inline Mask4 and4(Mask4 a, Mask4 b) { return _mm_and_ps(a, b); }
+    inline Float4 select4(Mask4 m, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    inline bool any4(Mask4 m) { return _mm_movemask_ps(m) != 0; }
+#else
+    struct Float4 { float v[4]; };
+    struct Mask4 { bool v[4]; };
+    inline Float4 splat4(float v) { return {{ v, v, v, v }}; }
+    inline Float4 load4(const float* p) { return {{ p[0], p[1], p[2], p[3] }}; }
+    inline void store4(float* p, Float4 v) { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+    inline Float4 add4(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+    inline Float4 mul4(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+    inline Mask4 greaterEqual4(Float4 a, Float4 b) { Mask4 m; for (int i = 0; i < 4; i++) m.v[i] = a.v[i] >= b.v[i]; return m; }
+    inline Mask4 greater4(Float4 a, Float4 b) { Mask4 m; for (int i = 0; i < 4; i++) m.v[i] = a.v[i] > b.v[i]; return m; }
+    inline Mask4 and4(Mask4 a, Mask4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] && b.v[i]; return a; }
+    inline Float4 select4(Mask4 m, Float4 a, Float4 b) { for (int i = 0; i < 4; i++) if (!m.v[i]) a.v[i] = b.v[i]; return a; }
+    inline bool any4(Mask4 m) { return m.v[0] || m.v[1] || m.v[2] || m.v[3]; }
+#endif
+
+    static_assert(OcclusionCuller::WIDTH % 4 == 0, "righe del depth buffer a gruppi di 4 pixel");
+
+    // Intervallo di colonne allargato a gruppi di 4 allineati (sempre dentro la riga)
+    inline int alignDown4(int x) { return x & ~3; }
+    inline int alignUp4(int x) { return x | 3; }
+
+    // Centri dei 4 pixel di un gruppo rispetto al primo
+    const float LANE_OFFSETS[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+
+    // Vertici più vicini di così (w in clip space, ~ near plane) non si proiettano in modo affidabile
+    constexpr float MIN_W = 0.1f;
+
+    // Punto proiettato: x, y in pixel del depth buffer, z in NDC
+    bool project(const glm::mat4& viewProj, const glm::vec3& p, glm::vec3& out) {
+        glm::vec4 clip = viewProj * glm::vec4(p, 1.0f);
+        if (clip.w < MIN_W) return false;
+        float invW = 1.0f / clip.w;
+        out.x = (clip.x * invW * 0.5f + 0.5f) * OcclusionCuller::WIDTH;
+        out.y = (clip.y * invW * 0.5f + 0.5f) * OcclusionCuller::HEIGHT;
+        out.z = clip.z * invW;
+        return true;
+    }
+
+    // Spigoli del box: bit 0 = x, bit 1 = y, bit 2 = z (0 = min, 1 = max)
+    bool projectCorners(const glm::mat4& viewProj, const CullBox& box, glm::vec3 (&out)[8]) {
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner((i & 1) ? box.max.x : box.min.x,
+                             (i & 2) ? box.max.y : box.min.y,
+                             (i & 4) ? box.max.z : box.min.z);
+            if (!project(viewProj, corner, out[i])) return false;
+        }
+        return true;
+    }
+
+    // Funzione di spigolo p0->p1 in forma affine: E(p) = a*x + b*y + c
+    struct Edge {
+        float a, b, c;
+        Edge(const glm::vec3& p0, const glm::vec3& p1)
+            : a(p0.y - p1.y), b(p1.x - p0.x), c(p0.x * p1.y - p0.y * p1.x) {}
+    };
+}
+
+OcclusionCuller::OcclusionCuller() : depth(WIDTH * HEIGHT, 1.0f) {
+    worker = std::thread([this]() { workerLoop(); });
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void OcclusionCuller::start(const glm::mat4& viewProjection, const glm::vec3& cameraPos) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        viewProj = viewProjection;
+        eye = cameraPos;
+        hasWork = true;
+        busy = true;
+    }
+    wake.notify_one();
+}
+
+const std::vector<unsigned char>& OcclusionCuller::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return !busy; });
+    return visible;
+}
+
+void OcclusionCuller::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return hasWork || quit; });
+        if (quit) return;
+        hasWork = false;
+
+        lock.unlock();
+        run();
+        lock.lock();
+
+        busy = false;
+        finished.notify_one();
+    }
+}
+
+void OcclusionCuller::run() {
+    auto begin = std::chrono::steady_clock::now();
+
+    std::fill(depth.begin(), depth.end(), 1.0f);
+    for (const CullBox& box : occluders) rasterizeBox(box);
+
+    visible.resize(queries.size());
+    occludedCount = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        visible[i] = isBoxVisible(queries[i]) ? 1 : 0;
+        if (!visible[i]) occludedCount++;
+    }
+
+    elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void OcclusionCuller::rasterizeBox(const CullBox& box) {
+    glm::vec3 corners[8];
+    if (!projectCorners(viewProj, box, corners)) return; // Attraversa il near plane: non occlude nulla
+
+    // Solo le facce rivolte verso la camera (al massimo tre), ognuna come due triangoli
+    static constexpr int FACES[6][4] = {
+        {0, 2, 6, 4}, {1, 3, 7, 5}, // x min, x max
+        {0, 1, 5, 4}, {2, 3, 7, 6}, // y min, y max
+        {0, 1, 3, 2}, {4, 5, 7, 6}  // z min, z max
+    };
+    bool facing[6] = {
+        eye.x < box.min.x, eye.x > box.max.x,
+        eye.y < box.min.y, eye.y > box.max.y,
+        eye.z < box.min.z, eye.z > box.max.z
+    };
+    for (int face = 0; face < 6; face++) {
+        if (!facing[face]) continue;
+        const int* q = FACES[face];
+        rasterizeTriangle(corners[q[0]], corners[q[1]], corners[q[2]]);
+        rasterizeTriangle(corners[q[0]], corners[q[2]], corners[q[3]]);
+    }
+}
+
+void OcclusionCuller::rasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    Edge ab(a, b), bc(b, c), ca(c, a);
+    float area = ab.a * c.x + ab.b * c.y + ab.c;
+    if (std::fabs(area) < 1e-6f) return;
+    // Verso indipendente dal winding: le funzioni di spigolo diventano tutte >= 0 all'interno
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+    area *= sign;
+
+    int minX = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+    int maxX = std::min(WIDTH - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+    int maxY = std::min(HEIGHT - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+    if (minX > maxX || minY > maxY) return;
+
+    // z interpolata linearmente nello schermo (z/w è affine in x, y): z = za*x + zb*y + zc
+    float invArea = 1.0f / area;
+    float za = (bc.a * a.z + ca.a * b.z + ab.a * c.z) * sign * invArea;
+    float zb = (bc.b * a.z + ca.b * b.z + ab.b * c.z) * sign * invArea;
+    float zc = (bc.c * a.z + ca.c * b.z + ab.c * c.z) * sign * invArea;
+
+    // 4 pixel per iterazione, senza salti: i pixel in più del gruppo allineato stanno fuori dal bounding box,
+    // quindi fuori dal triangolo, e le funzioni di spigolo li scartano
+    minX = alignDown4(minX);
+    maxX = alignUp4(maxX);
+    const Float4 zero = splat4(0.0f), lanes = load4(LANE_OFFSETS);
+    const Float4 a0 = splat4(bc.a * sign), a1 = splat4(ca.a * sign), a2 = splat4(ab.a * sign), az = splat4(za);
+    for (int y = minY; y <= maxY; y++) {
+        float py = static_cast<float>(y) + 0.5f;
+        Float4 r0 = splat4((bc.b * py + bc.c) * sign), r1 = splat4((ca.b * py + ca.c) * sign), r2 = splat4((ab.b * py + ab.c) * sign);
+        Float4 rz = splat4(zb * py + zc);
+        float* row = &depth[y * WIDTH];
+        for (int x = minX; x <= maxX; x += 4) {
+            Float4 px = add4(splat4(static_cast<float>(x) + 0.5f), lanes);
+            Float4 e0 = add4(mul4(a0, px), r0);
+            Float4 e1 = add4(mul4(a1, px), r1);
+            Float4 e2 = add4(mul4(a2, px), r2);
+            Float4 z = add4(mul4(az, px), rz);
+            Float4 old = load4(row + x);
+            Mask4 write = and4(and4(greaterEqual4(e0, zero), greaterEqual4(e1, zero)),
+                               and4(greaterEqual4(e2, zero), greater4(old, z)));
+            store4(row + x, select4(write, z, old));
+        }
+    }
+}
+
+bool OcclusionCuller::isBoxVisible(const CullBox& box) const {
+    glm::vec3 corners[8];
+    if (!projectCorners(viewProj, box, corners)) return true; // Attraversa il near plane: sempre visibile
+
+    float minXf = corners[0].x, maxXf = corners[0].x, minYf = corners[0].y, maxYf = corners[0].y;
+    float nearestZ = corners[0].z;
+    for (int i = 1; i < 8; i++) {
+        minXf = std::min(minXf, corners[i].x); maxXf = std::max(maxXf, corners[i].x);
+        minYf = std::min(minYf, corners[i].y); maxYf = std::max(maxYf, corners[i].y);
+        nearestZ = std::min(nearestZ, corners[i].z);
+    }
+
+    // Rettangolo di tutti i pixel toccati (conservativo)
+    int minX = std::max(0, static_cast<int>(std::floor(minXf)));
+    int maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(maxXf)));
+    int minY = std::max(0, static_cast<int>(std::floor(minYf)));
+    int maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(maxYf)));
+    if (minX > maxX || minY > maxY) return true;
+
+    // Visibile se in almeno un pixel l'occluder più vicino sta dietro il punto più vicino del box.
+    // Gruppi di 4 allineati: qualche pixel in più rende il test solo più conservativo
+    const Float4 nearest = splat4(nearestZ);
+    for (int y = minY; y <= maxY; y++) {
+        const float* row = &depth[y * WIDTH];
+        for (int x = alignDown4(minX); x <= alignUp4(maxX); x += 4)
+            if (any4(greater4(load4(row + x), nearest))) return true;
+    }
+    return false;
+}
@@ -0,0 +1,68 @@
+#include "SectionVisibility.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Spostamento in (x, sezione, z) attraverso ogni faccia, nell'ordine di SectionFace
+    constexpr int STEP[SectionFace::COUNT][3] = {
+        {-1, 0, 0}, {1, 0, 0},
+        {0, -1, 0}, {0, 1, 0},
+        {0, 0, -1}, {0, 0, 1}
+    };
+}
+
+void SectionVisibility::compute(const std::unordered_map<long long, std::shared_ptr<Chunk>>& chunks, const Camera& camera) {
+    int cameraChunkX = static_cast<int>(std::floor(camera.Position.x / Chunk::SIZE));
+    int cameraChunkZ = static_cast<int>(std::floor(camera.Position.z / Chunk::SIZE));
+    int cameraSection = static_cast<int>(std::floor(camera.Position.y / Chunk::SECTION_SIZE));
+    originX = cameraChunkX - RADIUS;
+    originZ = cameraChunkZ - RADIUS;
+    visited = 0;
+
+    active = cameraSection >= 0 && cameraSection < Chunk::SECTIONS
+          && chunks.find(chunkHash(cameraChunkX, cameraChunkZ)) != chunks.end();
+    if (!active) return;
+
+    for (int x = 0; x < SIDE; x++) {
+        for (int z = 0; z < SIDE; z++) {
+            auto it = chunks.find(chunkHash(originX + x, originZ + z));
+            grid[x * SIDE + z] = it != chunks.end() ? it->second.get() : nullptr;
+        }
+    }
+    std::fill(reached.begin(), reached.end(), 0);
+
+    queue.clear();
+    queue.push_back({ RADIUS, RADIUS, cameraSection, -1, 0 });
+    reached[RADIUS * SIDE + RADIUS] = static_cast<unsigned char>(1u << cameraSection);
+
+    // La coda cresce in fondo: indice di lettura invece di pop (nessuno spostamento)
+    for (size_t head = 0; head < queue.size(); head++) {
+        Node node = queue[head];
+        uint64_t connectivity = grid[node.x * SIDE + node.z]->sectionConnectivity[node.y];
+
+        for (int face = 0; face < SectionFace::COUNT; face++) {
+            if (node.directions & (1u << (face ^ 1))) continue; // Non tornare indietro
+            if (node.entry >= 0 && !Chunk::facesConnected(connectivity, node.entry, face)) continue;
+
+            int nx = node.x + STEP[face][0], ny = node.y + STEP[face][1], nz = node.z + STEP[face][2];
+            if (nx < 0 || nx >= SIDE || nz < 0 || nz >= SIDE || ny < 0 || ny >= Chunk::SECTIONS) continue;
+            int cell = nx * SIDE + nz;
+            if (!grid[cell] || (reached[cell] & (1u << ny))) continue;
+
+            glm::vec3 min((originX + nx) * Chunk::SIZE, ny * Chunk::SECTION_SIZE, (originZ + nz) * Chunk::SIZE);
+            glm::vec3 max = min + glm::vec3(Chunk::SIZE, Chunk::SECTION_SIZE, Chunk::SIZE);
+            if (!camera.frustum.isBoxVisible(min, max)) continue;
+
+            reached[cell] |= static_cast<unsigned char>(1u << ny);
+            queue.push_back({ nx, nz, ny, face ^ 1, static_cast<unsigned char>(node.directions | (1u << face)) });
+        }
+    }
+    visited = queue.size();
+}
+
+unsigned char SectionVisibility::visibleSections(int chunkX, int chunkZ) const {
+    if (!active) return 0xFF;
+    int x = chunkX - originX, z = chunkZ - originZ;
+    if (x < 0 || x >= SIDE || z < 0 || z >= SIDE) return 0;
+    return reached[x * SIDE + z];
+}
@@ -2,8 +2,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include "GLHeaders.hpp"
 #include <GLFW/glfw3.h>
-#include <OpenGL/gl3.h> // Header fondamentale su Mac
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     std::string vertexCode;
@@ -70,18 +70,50 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // Eliminiamo gli shader una volta linkati, non servono più
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    cacheUniformLocations();
+}
+
+void Shader::cacheUniformLocations() {
+    int count = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    for (int i = 0; i < count; i++) {
+        char name[128];
+        int length = 0, size = 0;
+        unsigned int type = 0;
+        glGetActiveUniform(ID, i, sizeof(name), &length, &size, &type, name);
+        // Le uniform dentro un blocco non hanno location (-1): vivono nell'UBO
+        int location = glGetUniformLocation(ID, name);
+        if (location >= 0) uniformLocations[name] = location;
+    }
+}
+
+int Shader::uniformLocation(const std::string &name) const {
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
 }
 
 void Shader::use() const {
     glUseProgram(ID);
 }
 
-// Utility per le Uniform (ci serviranno per la telecamera)
-void Shader::setBool(const std::string &name, bool value) const { glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); }
-void Shader::setInt(const std::string &name, int value) const { glUniform1i(glGetUniformLocation(ID, name.c_str()), value); }
-void Shader::setFloat(const std::string &name, float value) const { glUniform1f(glGetUniformLocation(ID, name.c_str()), value); }
+// Utility per le Uniform (location dalla cache, niente glGetUniformLocation a ogni chiamata)
+void Shader::setBool(const std::string &name, bool value) const { glUniform1i(uniformLocation(name), (int)value); }
+void Shader::setInt(const std::string &name, int value) const { glUniform1i(uniformLocation(name), value); }
+void Shader::setFloat(const std::string &name, float value) const { glUniform1f(uniformLocation(name), value); }
 
-// Aggiungi l'implementazione in fondo al file
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(uniformLocation(name), mat);
+}
+
+void Shader::setInt(int location, int value) const { glUniform1i(location, value); }
+void Shader::setIVec2(int location, int x, int y) const { glUniform2i(location, x, y); }
+
+void Shader::setMat4(int location, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::bindUniformBlock(const std::string &blockName, unsigned int bindingPoint) const {
+    unsigned int index = glGetUniformBlockIndex(ID, blockName.c_str());
+    if (index != GL_INVALID_INDEX) glUniformBlockBinding(ID, index, bindingPoint);
 }
\ No newline at end of file
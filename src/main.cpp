@@ -1,5 +1,4 @@
-#define GL_SILENCE_DEPRECATION
-#include <OpenGL/gl3.h>
+#include "GLHeaders.hpp"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,38 +7,68 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstdio>
+#include <optional>
+#include <span>
 #include <unordered_map>
-#include <future>
-#include <list>
-#include <unordered_set>
 #include "Shader.hpp"
 #include "Camera.hpp"
 #include "Chunk.hpp"
 #include "ThreadPool.hpp"
+#include "ChunkMeshArena.hpp"
+#include "ChunkDrawBatch.hpp"
+#include "ChunkDrawOrder.hpp"
+#include "FragmentCounter.hpp"
+#include "OcclusionCuller.hpp"
+#include "SectionVisibility.hpp"
+#include "ChunkScheduler.hpp"
+#include "ChunkKeySet.hpp"
+#include "CompletionQueue.hpp"
+#include "ChunkTask.hpp"
+#include "FrameBudget.hpp"
+#include "Decoration.hpp"
 #include "stb_image.h"
 
 // --- GLOBALI ---
 Camera camera(glm::vec3(8.0f, 80.0f, 30.0f));
-std::unordered_map<long long, std::unique_ptr<Chunk>> worldChunks;
-ThreadPool chunkThreadPool(std::max(2u, std::thread::hardware_concurrency() - 1));
+// Mesh di tutti i chunk (~1M vertici e indici per 16k quad di partenza, raddoppia se serve).
+// Prima di worldChunks: i chunk le restituiscono i loro intervalli quando vengono distrutti.
+ChunkMeshArena chunkMeshes(1 << 20, 1 << 14);
+ChunkDrawBatch chunkDraws; // Multi-draw indirect (GL 4.3+), vuoto sul percorso per chunk
+ChunkDrawOrder chunkDrawOrder;   // Chunk dal più vicino al più lontano (invalidato quando la mappa cambia)
+FragmentCounter fragmentCounter; // Frammenti dei chunk per frame (O alterna ordinato/non ordinato)
+SectionVisibility sectionVisibility; // Sezioni raggiungibili dalla camera (cave culling)
+OcclusionCuller occlusionCuller; // Depth buffer software sul suo thread, in parallelo con updateChunks
+std::vector<long long> cullKeys; // Chunk di occlusionCuller.queries, nello stesso ordine (vicini prima)
+constexpr size_t OCCLUDER_CHUNKS = 32; // I chunk più vicini nel frustum rasterizzati come occluder
+// shared_ptr: le coroutine dei job tengono vivi i chunk scaricati fino al termine.
+// Le coroutine terminano sempre sul thread principale, così l'ultimo riferimento (e il rilascio GL) resta lì.
+std::unordered_map<long long, std::shared_ptr<Chunk>> worldChunks;
+CompletionQueue mainThreadQueue; // Coroutine pronte a riprendere sul thread principale
 const std::string SAVE_DIR = "../world_save";
-
-struct PendingChunk {
-    long long key;
-    int x, z;
-    std::future<void> task;
-};
-std::list<PendingChunk> generationQueue;
-std::unordered_set<long long> queuedKeys; // O(1) lookup per evitare duplicati
-std::vector<Chunk*> uploadQueue;
-
-// Coda per rebuild asincroni (break/place blocchi)
-struct PendingRebuild {
-    std::vector<Chunk*> chunks;
-    std::future<void> task;
+PendingBlockStore pendingBlocks; // Scritture cross-chunk delle decorazioni
+ChunkScheduler chunkScheduler;    // Job non ancora inviati al pool, ordinati per priorità (e record dei job)
+// Dopo tutto ciò che i job usano: distrutti per primi, i worker finiscono prima che il resto sparisca.
+// Due executor: calcolo (terreno, decorazioni, mesh) e I/O (letture da disco), ognuno con la sua coda.
+// L'I/O passa i chunk al calcolo, quindi il pool I/O va distrutto prima: dichiarato dopo.
+ThreadPool computeThreadPool(std::max(2u, std::thread::hardware_concurrency() - 1));
+ThreadPool ioThreadPool(WorldConfig::IO_THREADS);
+FrameBudget mainThreadBudget(WorldConfig::MAIN_THREAD_BUDGET_MS);
+
+size_t jobsInFlight = 0; // Job che hanno ottenuto uno slot e non sono ancora tornati sul thread principale
+// Chunk in generazione o in salvataggio: non ricrearli. Slot preallocati, nessuna allocazione per job
+ChunkKeySet queuedKeys(4 * (2 * WorldConfig::GENERATION_DISTANCE + 1) * (2 * WorldConfig::GENERATION_DISTANCE + 1));
+std::vector<long long> deferredLandedKeys; // Scritture pendenti su chunk letti da un mesh job in corso
+
+// Modifica del giocatore rinviata finché un mesh job in corso legge il chunk (applicate in ordine)
+struct BlockEdit {
+    int x, y, z;
+    unsigned char block;
 };
-std::list<PendingRebuild> rebuildQueue;
+std::vector<BlockEdit> deferredEdits;
 
 float lastX = 640.0f, lastY = 360.0f;
 bool firstMouse = true;
@@ -47,9 +76,10 @@ float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
 // Blocco selezionato per il piazzamento
-const unsigned char placeableBlocks[] = { BlockType::GRASS, BlockType::DIRT, BlockType::STONE, BlockType::BEDROCK };
-const char* blockNames[] = { "Grass", "Dirt", "Stone", "Bedrock" };
-const int PLACEABLE_COUNT = 4;
+const unsigned char placeableBlocks[] = { BlockType::GRASS, BlockType::DIRT, BlockType::STONE, BlockType::BEDROCK,
+                                         BlockType::SAND, BlockType::SANDSTONE, BlockType::SNOW, BlockType::GRAVEL };
+const char* blockNames[] = { "Grass", "Dirt", "Stone", "Bedrock", "Sand", "Sandstone", "Snow", "Gravel" };
+const int PLACEABLE_COUNT = 8;
 int selectedBlockIndex = 2; // Default: pietra
 
 // Render distance ora in WorldConfig::RENDER_DISTANCE
@@ -106,114 +136,420 @@ void drawCrosshair() {
     glDrawArrays(GL_LINES, 0, 4);
 }
 
+// --- UNIFORM DELLA CAMERA (UBO) ---
+// projection e view caricate una volta per frame, lette da tutti gli shader dei chunk (blocco CameraBlock)
+constexpr unsigned int CAMERA_UBO_BINDING = 0;
+unsigned int cameraUBO;
+
+void setupCameraUniforms() {
+    glGenBuffers(1, &cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UBO_BINDING, cameraUBO);
+}
+
+void updateCameraUniforms(const glm::mat4& projection, const glm::mat4& view) {
+    // std140: due mat4 consecutive, colonna per colonna come glm
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(projection));
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(view));
+}
+
+// --- OCCLUSION CULLING ---
+// Prima il grafo delle sezioni (scarta i chunk non raggiungibili dalla camera, es. la superficie vista da una grotta),
+// poi il depth buffer software sugli altri.
+// Query: box dei chunk nel frustum (estensione verticale della mesh, ristretta alle sezioni raggiunte).
+// Occluder: le celle piene dei chunk più vicini.
+// Chiavi e non puntatori: updateChunks gira mentre il culler lavora e può scaricare chunk.
+void startOcclusionCulling(const glm::mat4& viewProjection) {
+    sectionVisibility.compute(worldChunks, camera);
+
+    occlusionCuller.occluders.clear();
+    occlusionCuller.queries.clear();
+    cullKeys.clear();
+
+    int cameraChunkX = static_cast<int>(std::floor(camera.Position.x / Chunk::SIZE));
+    int cameraChunkZ = static_cast<int>(std::floor(camera.Position.z / Chunk::SIZE));
+    for (Chunk* chunk : chunkDrawOrder.update(worldChunks, cameraChunkX, cameraChunkZ)) {
+        if (!chunk->isUploaded) continue;
+        glm::vec3 min = chunk->getMin();
+        glm::vec3 max = chunk->getMax();
+        unsigned char sections = sectionVisibility.visibleSections(chunk->chunkX, chunk->chunkZ);
+        if (sections == 0) continue;
+        int lowest = std::countr_zero(sections), highest = 7 - std::countl_zero(sections);
+        min.y = static_cast<float>(std::max(chunk->meshMinY, lowest * Chunk::SECTION_SIZE));
+        max.y = static_cast<float>(std::min(chunk->meshMaxY, (highest + 1) * Chunk::SECTION_SIZE));
+        if (min.y >= max.y || !camera.frustum.isBoxVisible(min, max)) continue;
+
+        occlusionCuller.queries.push_back({ min, max });
+        cullKeys.push_back(chunkHash(chunk->chunkX, chunk->chunkZ));
+        if (cullKeys.size() > OCCLUDER_CHUNKS) continue;
+
+        for (int cx = 0; cx < Chunk::OCCLUDER_CELLS; cx++) {
+            for (int cz = 0; cz < Chunk::OCCLUDER_CELLS; cz++) {
+                int height = chunk->occluderHeights[cx][cz];
+                if (height == 0) continue;
+                glm::vec3 cellMin = min + glm::vec3(cx * Chunk::OCCLUDER_CELL, 0, cz * Chunk::OCCLUDER_CELL);
+                cellMin.y = 0.0f;
+                glm::vec3 cellMax(cellMin.x + Chunk::OCCLUDER_CELL, static_cast<float>(height), cellMin.z + Chunk::OCCLUDER_CELL);
+                occlusionCuller.occluders.push_back({ cellMin, cellMax });
+            }
+        }
+    }
+    occlusionCuller.start(viewProjection, camera.Position);
+}
+
 // --- HELPER: costruisce i vicini di un chunk ---
 ChunkNeighbors getNeighbors(int cx, int cz) {
     ChunkNeighbors n;
     auto it = worldChunks.find(chunkHash(cx - 1, cz));
-    if (it != worldChunks.end()) n.left = it->second.get();
+    if (it != worldChunks.end() && it->second->isGenerated) n.left = it->second.get();
     it = worldChunks.find(chunkHash(cx + 1, cz));
-    if (it != worldChunks.end()) n.right = it->second.get();
+    if (it != worldChunks.end() && it->second->isGenerated) n.right = it->second.get();
     it = worldChunks.find(chunkHash(cx, cz + 1));
-    if (it != worldChunks.end()) n.front = it->second.get();
+    if (it != worldChunks.end() && it->second->isGenerated) n.front = it->second.get();
     it = worldChunks.find(chunkHash(cx, cz - 1));
-    if (it != worldChunks.end()) n.back = it->second.get();
+    if (it != worldChunks.end() && it->second->isGenerated) n.back = it->second.get();
     return n;
 }
 
-// --- GESTIONE MONDO ASINCRONA ---
-void updateChunks() {
+// True se un mesh job già inviato al pool legge i blocchi del chunk (cx, cz):
+// il suo, o quello di un vicino che ne legge la colonna di bordo tramite ChunkNeighbors.
+// I job ancora in coda non contano: leggeranno i blocchi dopo la scrittura
+bool isReadByMeshJob(int cx, int cz) {
+    for (long long key : { chunkHash(cx, cz), chunkHash(cx - 1, cz), chunkHash(cx + 1, cz), chunkHash(cx, cz - 1), chunkHash(cx, cz + 1) }) {
+        auto it = worldChunks.find(key);
+        if (it != worldChunks.end() && it->second->meshJob && it->second->meshJob->running) return true;
+    }
+    return false;
+}
+
+// --- CICLO DI VITA DEI CHUNK (coroutine) ---
+// Ogni fase è un co_await: slot dello scheduler (thread principale) -> pool I/O / calcolo -> thread principale.
+// Il ritorno sul thread principale avviene nel drain di mainThreadQueue, dentro il budget del frame.
+
+void queueRebuild(std::span<const std::shared_ptr<Chunk>> chunks, ChunkJobKind kind);
+
+// Remesh di un gruppo di chunk: mesh sul pool di calcolo, upload GL sul thread principale
+ChunkTask remeshChunks(ChunkJob* job) {
+    if (co_await chunkScheduler.slot(job)) {
+        job->running = true;
+        co_await resumeOn(computeThreadPool);
+        for (size_t i = 0; i < job->chunks.size(); i++) {
+            Chunk& chunk = *job->chunks[i];
+            if (!chunk.cancelled.load(std::memory_order_relaxed))
+                chunk.rebuildMeshOnly(job->meshNeighbors[i]);
+        }
+        co_await resumeOnMainThread(mainThreadQueue);
+        jobsInFlight--;
+    }
+
+    // Libera i chunk, poi rilancia una sola volta quelli cambiati mentre il job era in volo
+    for (const auto& chunk : job->chunks) {
+        chunk->meshJob = nullptr;
+        if (chunk->cancelled.load(std::memory_order_relaxed)) continue;
+        if (chunk->needsReupload) chunk->reupload(chunkMeshes);
+    }
+    for (const auto& chunk : job->chunks) {
+        if (chunk->remeshKind < 0) continue;
+        auto kind = static_cast<ChunkJobKind>(chunk->remeshKind);
+        chunk->remeshKind = -1;
+        if (!chunk->cancelled.load(std::memory_order_relaxed)) queueRebuild(std::span(&chunk, 1), kind);
+    }
+    chunkScheduler.release(job);
+}
+
+// Accoda un unico job di remesh per un gruppo di chunk (upload su GPU al completamento).
+// Mai due job sullo stesso chunk: se ne ha già uno ancora in coda quello leggerà i blocchi aggiornati
+// (al più sale di classe), se è già in volo il chunk viene rilanciato al suo termine
+void queueRebuild(std::span<const std::shared_ptr<Chunk>> chunks, ChunkJobKind kind) {
+    ChunkJob* job = nullptr;
+    for (const auto& chunk : chunks) {
+        if (chunk->meshJob) {
+            if (!chunkScheduler.promote(chunk->meshJob, kind))
+                chunk->remeshKind = chunk->remeshKind < 0 ? static_cast<int>(kind)
+                                                          : std::min(chunk->remeshKind, static_cast<int>(kind));
+            continue;
+        }
+        if (!job) job = chunkScheduler.acquire();
+        int cx = chunk->chunkX, cz = chunk->chunkZ;
+        job->chunks.push_back(chunk);
+        job->meshNeighbors.push_back(getNeighbors(cx, cz));
+        for (long long key : { chunkHash(cx - 1, cz), chunkHash(cx + 1, cz), chunkHash(cx, cz - 1), chunkHash(cx, cz + 1) }) {
+            auto it = worldChunks.find(key);
+            if (it != worldChunks.end()) job->neighbors.push_back(it->second);
+        }
+        chunk->meshJob = job;
+    }
+    if (!job) return;
+
+    job->kind = kind;
+    job->chunkX = job->chunks[0]->chunkX;
+    job->chunkZ = job->chunks[0]->chunkZ;
+    job->key = chunkHash(job->chunkX, job->chunkZ);
+    remeshChunks(job);
+}
+
+// Salvataggio di un chunk scaricato sul pool I/O. La chiave resta in queuedKeys
+// finché il file non è scritto, così il chunk non viene ricaricato a metà salvataggio.
+ChunkTask saveChunk(std::shared_ptr<Chunk> chunk) {
+    long long key = chunkHash(chunk->chunkX, chunk->chunkZ);
+    queuedKeys.insert(key);
+    co_await resumeOn(ioThreadPool);
+    chunk->saveToFile(SAVE_DIR);
+    co_await resumeOnMainThread(mainThreadQueue);
+    queuedKeys.erase(key);
+}
+
+// Riprende le coroutine a cui lo scheduler dà uno slot. Pochi job in volo alla volta (2 per worker):
+// il resto aspetta nello scheduler, dove le priorità seguono la camera
+void dispatchChunkJobs() {
+    size_t maxInFlight = (computeThreadPool.size() + ioThreadPool.size()) * 2;
+    size_t slots = jobsInFlight < maxInFlight ? maxInFlight - jobsInFlight : 0;
+
+    for (ChunkJob* job : chunkScheduler.takeReady(slots)) {
+        jobsInFlight++;
+        job->waiter.resume(); // Prosegue fino al passaggio su un pool
+    }
+}
+
+// Riaccoda le chiome dei vicini già generati che sconfinano nel chunk (es. chunk ricaricato)
+void reemitNeighborSpill(int cx, int cz) {
+    long long target = chunkHash(cx, cz);
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            if (dx == 0 && dz == 0) continue;
+            long long key = chunkHash(cx + dx, cz + dz);
+            auto it = worldChunks.find(key);
+            if (it == worldChunks.end() || queuedKeys.contains(key)) continue;
+            decorateChunk(*it->second, pendingBlocks, false, target);
+        }
+    }
+}
+
+// Livello di dettaglio per un chunk a `distance` chunk (Chebyshev) dal giocatore.
+// Verso un livello più grossolano solo un chunk oltre l'inizio del suo anello: chi cammina avanti e indietro
+// sul bordo di un anello non fa rimeshare tutto l'anello a ogni passo
+int lodLevelAt(int distance) {
+    int level = 0;
+    while (level + 1 < WorldConfig::LOD_LEVELS && distance >= WorldConfig::LOD_RING_START[level + 1]) level++;
+    return level;
+}
+
+int lodForDistance(int distance, int current) {
+    int level = lodLevelAt(distance);
+    return level > current ? std::max(current, lodLevelAt(distance - 1)) : level;
+}
+
+int chunkDistance(const Chunk& chunk, int playerChunkX, int playerChunkZ) {
+    return std::max(abs(chunk.chunkX - playerChunkX), abs(chunk.chunkZ - playerChunkZ));
+}
+
+// Grafo dei task: "mesh (x,z)" dipende da "genera" di (x,z) e dei 4 vicini.
+// Chiamata al completamento di ogni generazione: controlla il chunk e i suoi vicini
+// e lancia il meshing di quelli che hanno ora tutte le dipendenze soddisfatte.
+// Il controllo è idempotente, quindi resta corretto anche se un vicino viene scaricato e rigenerato.
+void onChunkGenerated(int cx, int cz) {
+    const int offsets[5][2] = { {0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
     int playerChunkX = static_cast<int>(floor(camera.Position.x / 16.0f));
     int playerChunkZ = static_cast<int>(floor(camera.Position.z / 16.0f));
+    auto isGenerated = [](int x, int z) {
+        auto it = worldChunks.find(chunkHash(x, z));
+        return it != worldChunks.end() && it->second->isGenerated;
+    };
 
-    for (int x = playerChunkX - WorldConfig::RENDER_DISTANCE; x <= playerChunkX + WorldConfig::RENDER_DISTANCE; x++) {
-        for (int z = playerChunkZ - WorldConfig::RENDER_DISTANCE; z <= playerChunkZ + WorldConfig::RENDER_DISTANCE; z++) {
-            long long key = chunkHash(x, z);
-
-            if (worldChunks.find(key) == worldChunks.end() && queuedKeys.find(key) == queuedKeys.end()) {
-                worldChunks[key] = std::make_unique<Chunk>(x, z);
-                Chunk* chunkPtr = worldChunks[key].get();
-                queuedKeys.insert(key);
-                std::string saveDir = SAVE_DIR;
-
-                generationQueue.push_back({
-                    key, x, z,
-                    chunkThreadPool.submit([chunkPtr, saveDir]() {
-                        // Carica da disco se esiste, altrimenti genera terreno
-                        if (!chunkPtr->loadFromFile(saveDir))
-                            chunkPtr->generateTerrain();
-                    })
-                });
-            }
+    for (const auto& o : offsets) {
+        auto it = worldChunks.find(chunkHash(cx + o[0], cz + o[1]));
+        if (it == worldChunks.end()) continue;
+        Chunk& chunk = *it->second;
+        if (!chunk.isGenerated || chunk.isMeshQueued) continue;
+
+        int x = chunk.chunkX, z = chunk.chunkZ;
+        if (isGenerated(x - 1, z) && isGenerated(x + 1, z) && isGenerated(x, z - 1) && isGenerated(x, z + 1)) {
+            chunk.isMeshQueued = true;
+            chunk.lod = lodLevelAt(chunkDistance(chunk, playerChunkX, playerChunkZ));
+            queueRebuild(std::span(&it->second, 1), ChunkJobKind::MESH);
         }
     }
+}
 
-    for (auto it = generationQueue.begin(); it != generationQueue.end(); ) {
-        if (it->task.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            long long key = it->key;
-            queuedKeys.erase(key);
-            if (worldChunks.find(key) != worldChunks.end()) {
-                uploadQueue.push_back(worldChunks[key].get());
+// Caricamento o generazione: disco sul pool I/O, terreno e decorazioni sul pool di calcolo,
+// poi sul thread principale le scritture arrivate nel frattempo e il via al meshing dei vicini pronti.
+// Tra una fase e l'altra controlla se il chunk è stato scaricato nel frattempo.
+ChunkTask generateChunk(std::shared_ptr<Chunk> chunk) {
+    Chunk& c = *chunk;
+    auto cancelled = [&c]() { return c.cancelled.load(std::memory_order_relaxed); };
+
+    ChunkJob* job = chunkScheduler.acquire();
+    job->kind = ChunkJobKind::GENERATE;
+    job->chunkX = c.chunkX;
+    job->chunkZ = c.chunkZ;
+    job->key = chunkHash(c.chunkX, c.chunkZ);
+    job->chunks.push_back(chunk);
+    queuedKeys.insert(job->key);
+
+    if (co_await chunkScheduler.slot(job)) {
+        co_await resumeOn(ioThreadPool);
+        bool loaded = !cancelled() && c.loadFromFile(SAVE_DIR);
+
+        // Un chunk caricato ha già i suoi alberi: accoda solo quelli che sconfinano
+        co_await resumeOn(computeThreadPool);
+        if (!cancelled()) {
+            if (!loaded)
+                c.generateTerrain();
+            if (!cancelled()) {
+                decorateChunk(c, pendingBlocks, !loaded);
+                applyPendingBlocks(c, pendingBlocks);
             }
-            it = generationQueue.erase(it);
-        } else {
-            ++it;
+        }
+
+        co_await resumeOnMainThread(mainThreadQueue);
+        jobsInFlight--;
+        if (!cancelled()) {
+            // Scritture arrivate dopo la generazione sul worker
+            reemitNeighborSpill(c.chunkX, c.chunkZ);
+            applyPendingBlocks(c, pendingBlocks);
+            c.isGenerated = true;
+            onChunkGenerated(c.chunkX, c.chunkZ);
         }
     }
+    queuedKeys.erase(job->key);
+    chunkScheduler.release(job);
+}
 
-    for (int i = 0; i < WorldConfig::UPLOADS_PER_FRAME && !uploadQueue.empty(); i++) {
-        Chunk* chunk = uploadQueue.back();
-        uploadQueue.pop_back();
-        chunk->rebuild(getNeighbors(chunk->chunkX, chunk->chunkZ));
+// Riprende le coroutine tornate sul thread principale: costo proporzionale ai completamenti, non ai job in volo
+void drainMainThreadQueue() {
+    for (int done = 0; ; done++) {
+        if (!mainThreadBudget.allows(done)) {
+            mainThreadBudget.defer(); // Le coroutine restanti aspettano in coda il prossimo frame
+            break;
+        }
+        CompletionNode* node = mainThreadQueue.pop();
+        if (!node) break;
+        resumeCompleted(node);
     }
+}
 
-    // Processa rebuild asincroni completati (GPU upload)
-    for (auto it = rebuildQueue.begin(); it != rebuildQueue.end(); ) {
-        if (it->task.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            for (Chunk* chunk : it->chunks) {
-                if (chunk->needsReupload) chunk->reupload();
+// --- GESTIONE MONDO ASINCRONA ---
+void updateChunks() {
+    mainThreadBudget.beginFrame();
+    int playerChunkX = static_cast<int>(floor(camera.Position.x / 16.0f));
+    int playerChunkZ = static_cast<int>(floor(camera.Position.z / 16.0f));
+
+    // Generazione fino a un anello oltre la render distance: il meshing parte quando i 4 vicini sono pronti
+    for (int x = playerChunkX - WorldConfig::GENERATION_DISTANCE; x <= playerChunkX + WorldConfig::GENERATION_DISTANCE; x++) {
+        for (int z = playerChunkZ - WorldConfig::GENERATION_DISTANCE; z <= playerChunkZ + WorldConfig::GENERATION_DISTANCE; z++) {
+            long long key = chunkHash(x, z);
+
+            if (worldChunks.find(key) == worldChunks.end() && !queuedKeys.contains(key)) {
+                worldChunks[key] = std::make_shared<Chunk>(x, z);
+                chunkDrawOrder.invalidate();
+                generateChunk(worldChunks[key]);
             }
-            it = rebuildQueue.erase(it);
-        } else {
-            ++it;
         }
     }
 
+    chunkScheduler.updateCamera(camera);
+    dispatchChunkJobs();
+
+    drainMainThreadQueue();
+
+    // Scritture pendenti atterrate su chunk già generati: applica e rimesha in un unico batch
+    std::vector<std::shared_ptr<Chunk>> landed;
+    std::vector<long long> dirtyKeys = pendingBlocks.takeDirtyKeys();
+    dirtyKeys.insert(dirtyKeys.end(), deferredLandedKeys.begin(), deferredLandedKeys.end());
+    deferredLandedKeys.clear();
+    for (size_t i = 0; i < dirtyKeys.size(); i++) {
+        long long key = dirtyKeys[i];
+        if (!mainThreadBudget.allows(static_cast<int>(i))) {
+            deferredLandedKeys.insert(deferredLandedKeys.end(), dirtyKeys.begin() + i, dirtyKeys.end());
+            mainThreadBudget.defer(dirtyKeys.size() - i);
+            break;
+        }
+        if (queuedKeys.contains(key)) continue; // Applicate al termine della generazione
+        auto found = worldChunks.find(key);
+        if (found == worldChunks.end()) continue; // Restano in coda finché il chunk non viene caricato
+        if (isReadByMeshJob(found->second->chunkX, found->second->chunkZ)) {
+            deferredLandedKeys.push_back(key); // Un worker sta leggendo i blocchi: riprova al prossimo frame
+            continue;
+        }
+        if (applyPendingBlocks(*found->second, pendingBlocks) && found->second->isMeshQueued)
+            landed.push_back(found->second);
+    }
+    if (!landed.empty()) queueRebuild(landed, ChunkJobKind::REMESH);
+
+    // Chunk che hanno cambiato anello LOD: nuova mesh sul pool di calcolo (un job per chunk, priorità di sfondo).
+    // Chi ha già un mesh job aspetta il prossimo frame: lod cambia solo quando nessun worker lo legge
+    for (auto& [key, chunk] : worldChunks) {
+        if (!chunk->isMeshQueued || chunk->meshJob) continue;
+        int level = lodForDistance(chunkDistance(*chunk, playerChunkX, playerChunkZ), chunk->lod);
+        if (level == chunk->lod) continue;
+        chunk->lod = level;
+        queueRebuild(std::span(&chunk, 1), ChunkJobKind::REMESH);
+    }
+
+    bool unloadedAny = false;
     for (auto it = worldChunks.begin(); it != worldChunks.end(); ) {
         int cx = it->second->chunkX;
         int cz = it->second->chunkZ;
         if (abs(cx - playerChunkX) > WorldConfig::UNLOAD_DISTANCE ||
             abs(cz - playerChunkZ) > WorldConfig::UNLOAD_DISTANCE) {
-            // Salva chunk modificati su disco prima di rimuoverli
+            // I job in volo lo vedono e terminano; il chunk vive finché le loro coroutine lo tengono
+            it->second->cancelled.store(true, std::memory_order_relaxed);
+            // Salva chunk modificati su disco prima di rimuoverli (sul pool I/O)
             if (it->second->modified)
-                it->second->saveToFile(SAVE_DIR);
+                saveChunk(it->second);
             it = worldChunks.erase(it);
+            chunkDrawOrder.invalidate();
+            unloadedAny = true;
         } else {
             ++it;
         }
     }
+    if (unloadedAny) {
+        // Lavoro mai partito per chunk scaricati (es. teleport): scartato subito,
+        // ogni coroutine riprende con lo slot negato e fa la sua pulizia
+        for (ChunkJob* job : chunkScheduler.takeCancelled())
+            job->waiter.resume();
+        pendingBlocks.pruneOutside(playerChunkX, playerChunkZ, WorldConfig::UNLOAD_DISTANCE + 1);
+    }
+    mainThreadBudget.endFrame();
 }
 
 void forceLoadInitialChunks() {
     int playerChunkX = static_cast<int>(floor(camera.Position.x / 16.0f));
     int playerChunkZ = static_cast<int>(floor(camera.Position.z / 16.0f));
     int initialRadius = WorldConfig::INITIAL_LOAD_RADIUS;
+    int generateRadius = initialRadius + 1; // I chunk del bordo hanno bisogno dei vicini
 
     // Prima genera tutto il terreno
-    for (int x = playerChunkX - initialRadius; x <= playerChunkX + initialRadius; x++) {
-        for (int z = playerChunkZ - initialRadius; z <= playerChunkZ + initialRadius; z++) {
+    for (int x = playerChunkX - generateRadius; x <= playerChunkX + generateRadius; x++) {
+        for (int z = playerChunkZ - generateRadius; z <= playerChunkZ + generateRadius; z++) {
             long long key = chunkHash(x, z);
             if (worldChunks.find(key) == worldChunks.end()) {
-                worldChunks[key] = std::make_unique<Chunk>(x, z);
-                if (!worldChunks[key]->loadFromFile(SAVE_DIR))
+                worldChunks[key] = std::make_shared<Chunk>(x, z);
+                chunkDrawOrder.invalidate();
+                bool loaded = worldChunks[key]->loadFromFile(SAVE_DIR);
+                if (!loaded)
                     worldChunks[key]->generateTerrain();
+                decorateChunk(*worldChunks[key], pendingBlocks, !loaded);
             }
         }
     }
-    // Poi costruisci mesh con vicini disponibili e carica su GPU
+    // Applica le chiome sconfinate tra i chunk iniziali
+    for (int x = playerChunkX - generateRadius; x <= playerChunkX + generateRadius; x++) {
+        for (int z = playerChunkZ - generateRadius; z <= playerChunkZ + generateRadius; z++) {
+            Chunk& chunk = *worldChunks[chunkHash(x, z)];
+            applyPendingBlocks(chunk, pendingBlocks);
+            chunk.isGenerated = true;
+        }
+    }
+    // Poi costruisci mesh con tutti i vicini presenti e carica su GPU
     for (int x = playerChunkX - initialRadius; x <= playerChunkX + initialRadius; x++) {
         for (int z = playerChunkZ - initialRadius; z <= playerChunkZ + initialRadius; z++) {
-            long long key = chunkHash(x, z);
-            worldChunks[key]->rebuild(getNeighbors(x, z));
+            Chunk& chunk = *worldChunks[chunkHash(x, z)];
+            chunk.isMeshQueued = true;
+            chunk.rebuild(chunkMeshes, getNeighbors(x, z));
         }
     }
 }
@@ -258,10 +594,10 @@ RaycastResult raycast(glm::vec3 origin, glm::vec3 dir, float maxDist) {
         int chunkZ = static_cast<int>(floor(z / 16.0f));
         auto it = worldChunks.find(chunkHash(chunkX, chunkZ));
 
-        if (it != worldChunks.end() && y >= 0 && y < Chunk::HEIGHT) {
+        if (it != worldChunks.end() && it->second->isGenerated && y >= 0 && y < Chunk::HEIGHT) {
             int localX = x % 16; if (localX < 0) localX += 16;
             int localZ = z % 16; if (localZ < 0) localZ += 16;
-            if (it->second->blocks[localX][y][localZ] != BlockType::AIR) {
+            if (it->second->getBlock(localX, y, localZ) != BlockType::AIR) {
                 result.hit = true;
                 result.x = x; result.y = y; result.z = z;
                 return result;
@@ -296,14 +632,13 @@ void rebuildChunkAndBorders(int blockX, int blockY, int blockZ) {
     int localX = blockX % 16; if (localX < 0) localX += 16;
     int localZ = blockZ % 16; if (localZ < 0) localZ += 16;
 
-    // Raccogli i chunk da ricostruire e i loro vicini
-    struct RebuildInfo { Chunk* chunk; ChunkNeighbors neighbors; };
-    std::vector<RebuildInfo> toRebuild;
-
+    // Raccogli il chunk modificato e quelli adiacenti al bordo
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    // Solo chunk con la mesh iniziale già lanciata: gli altri la costruiranno con i blocchi aggiornati
     auto addIfExists = [&](int cx, int cz) {
         auto it = worldChunks.find(chunkHash(cx, cz));
-        if (it != worldChunks.end())
-            toRebuild.push_back({it->second.get(), getNeighbors(cx, cz)});
+        if (it != worldChunks.end() && it->second->isMeshQueued)
+            chunks.push_back(it->second);
     };
 
     addIfExists(chunkX, chunkZ);
@@ -312,34 +647,45 @@ void rebuildChunkAndBorders(int blockX, int blockY, int blockZ) {
     if (localZ == 0) addIfExists(chunkX, chunkZ-1);
     if (localZ == 15) addIfExists(chunkX, chunkZ+1);
 
-    // Lancia mesh generation asincrona
-    std::vector<Chunk*> chunks;
-    for (auto& ri : toRebuild) chunks.push_back(ri.chunk);
+    // Mesh generation asincrona, davanti a tutto il resto
+    if (!chunks.empty()) queueRebuild(chunks, ChunkJobKind::EDIT_REMESH);
+}
+
+// Scrive una modifica del giocatore e rimesha. Restituisce false, senza scrivere, se un mesh job
+// in corso legge il chunk; una modifica su un chunk scaricato o ancora in generazione viene scartata
+bool tryApplyEdit(const BlockEdit& edit) {
+    int chunkX = static_cast<int>(floor(edit.x / 16.0f));
+    int chunkZ = static_cast<int>(floor(edit.z / 16.0f));
+    auto it = worldChunks.find(chunkHash(chunkX, chunkZ));
+    if (it == worldChunks.end() || !it->second->isGenerated) return true;
+    if (isReadByMeshJob(chunkX, chunkZ)) return false;
+
+    int localX = edit.x % 16; if (localX < 0) localX += 16;
+    int localZ = edit.z % 16; if (localZ < 0) localZ += 16;
+
+    it->second->setBlock(localX, edit.y, localZ, edit.block);
+    it->second->modified = true;
+    rebuildChunkAndBorders(edit.x, edit.y, edit.z);
+    return true;
+}
+
+// In coda dietro alle modifiche già rinviate, così rompi-e-piazza sullo stesso blocco resta in ordine
+void applyEdit(const BlockEdit& edit) {
+    if (!deferredEdits.empty() || !tryApplyEdit(edit)) deferredEdits.push_back(edit);
+}
 
-    rebuildQueue.push_back({
-        chunks,
-        chunkThreadPool.submit([toRebuild = std::move(toRebuild)]() {
-            for (auto& ri : toRebuild)
-                ri.chunk->rebuildMeshOnly(ri.neighbors);
-        })
-    });
+// Chiamata una volta per frame: applica le modifiche rinviate fino alla prima ancora bloccata
+void applyDeferredEdits() {
+    size_t applied = 0;
+    while (applied < deferredEdits.size() && tryApplyEdit(deferredEdits[applied])) applied++;
+    deferredEdits.erase(deferredEdits.begin(), deferredEdits.begin() + applied);
 }
 
 void breakBlock() {
     auto result = raycast(camera.Position, camera.Front, WorldConfig::INTERACTION_RANGE);
     if (!result.hit) return;
 
-    int chunkX = static_cast<int>(floor(result.x / 16.0f));
-    int chunkZ = static_cast<int>(floor(result.z / 16.0f));
-    auto it = worldChunks.find(chunkHash(chunkX, chunkZ));
-    if (it == worldChunks.end()) return;
-
-    int localX = result.x % 16; if (localX < 0) localX += 16;
-    int localZ = result.z % 16; if (localZ < 0) localZ += 16;
-
-    it->second->blocks[localX][result.y][localZ] = BlockType::AIR;
-    it->second->modified = true;
-    rebuildChunkAndBorders(result.x, result.y, result.z);
+    applyEdit({ result.x, result.y, result.z, BlockType::AIR });
 }
 
 void placeBlock() {
@@ -357,19 +703,8 @@ void placeBlock() {
     if (pMinX < px + 1.0f && pMaxX > px && pMinY < py + 1.0f && pMaxY > py && pMinZ < pz + 1.0f && pMaxZ > pz)
         return;
 
-    int chunkX = static_cast<int>(floor(px / 16.0f));
-    int chunkZ = static_cast<int>(floor(pz / 16.0f));
-    auto it = worldChunks.find(chunkHash(chunkX, chunkZ));
-    if (it == worldChunks.end()) return;
-
-    int localX = px % 16; if (localX < 0) localX += 16;
-    int localZ = pz % 16; if (localZ < 0) localZ += 16;
-
-    if (py >= 0 && py < Chunk::HEIGHT) {
-        it->second->blocks[localX][py][localZ] = placeableBlocks[selectedBlockIndex];
-        it->second->modified = true;
-        rebuildChunkAndBorders(px, py, pz);
-    }
+    if (py >= 0 && py < Chunk::HEIGHT)
+        applyEdit({ px, py, pz, placeableBlocks[selectedBlockIndex] });
 }
 
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
@@ -419,6 +754,12 @@ void processInput(GLFWwindow *window) {
         camera.Position = glm::vec3(8.0f, 80.0f, 8.0f);
         camera.yVelocity = 0.0f;
     }
+    // O: alterna l'ordine di disegno front-to-back (confronto dei frammenti nel titolo)
+    static bool orderKeyDown = false;
+    bool orderKeyPressed = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+    if (orderKeyPressed && !orderKeyDown)
+        chunkDrawOrder.setSorted(!chunkDrawOrder.isSorted());
+    orderKeyDown = orderKeyPressed;
 }
 
 unsigned int loadTextureArray(const std::vector<std::string>& faces) {
@@ -458,14 +799,28 @@ unsigned int loadTextureArray(const std::vector<std::string>& faces) {
     return textureArray;
 }
 
+// Finestra con il contesto core più recente disponibile: 4.6 / 4.3 abilitano multi-draw indirect e
+// il conteggio dei frammenti (es. Mesa su Linux); macOS si ferma a 4.1, che resta l'ultimo tentativo ovunque
+GLFWwindow* createWindow() {
+#ifdef __APPLE__
+    const int versions[][2] = { {4, 1} };
+#else
+    const int versions[][2] = { {4, 6}, {4, 3}, {4, 1} };
+#endif
+    for (const auto& version : versions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        GLFWwindow* window = glfwCreateWindow(1280, 720, "Minecraft Engine - alfanowski", nullptr, nullptr);
+        if (window) return window;
+    }
+    return nullptr;
+}
+
 int main() {
     if (!glfwInit()) return -1;
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Minecraft Engine - alfanowski", nullptr, nullptr);
+    GLFWwindow* window = createWindow();
     if (!window) { glfwTerminate(); return -1; }
 
     glfwMakeContextCurrent(window);
@@ -479,6 +834,18 @@ int main() {
     glEnable(GL_CULL_FACE); // Riabilitato Culling
 
     Shader ourShader("../shaders/vertex.glsl", "../shaders/fragment.glsl");
+    // Con GL 4.3+ un solo draw indiretto per tutti i chunk; altrimenti (GL 4.1) un draw per chunk con `chunkOffset`
+    std::optional<Shader> multiDrawShader;
+    if (chunkDraws.init(chunkMeshes))
+        multiDrawShader.emplace("../shaders/vertex_mdi.glsl", "../shaders/fragment.glsl");
+    const Shader& chunkShader = multiDrawShader ? *multiDrawShader : ourShader;
+    setupCameraUniforms();
+    chunkShader.bindUniformBlock("CameraBlock", CAMERA_UBO_BINDING);
+    // Uniform fisse impostate una volta; chunkOffset (percorso per chunk) risolta qui e non nel loop
+    chunkShader.use();
+    chunkShader.setInt("textureArray", 0);
+    const int chunkOffsetLocation = ourShader.uniformLocation("chunkOffset");
+    fragmentCounter.init();
     setupCrosshair();
 
     stbi_set_flip_vertically_on_load(true);
@@ -487,57 +854,108 @@ int main() {
         "../assets/block/grass_block_side.png", // 1
         "../assets/block/dirt.png",             // 2
         "../assets/block/stone.png",            // 3
-        "../assets/block/bedrock.png"           // 4
+        "../assets/block/bedrock.png",          // 4
+        "../assets/block/sand.png",             // 5
+        "../assets/block/sandstone.png",        // 6
+        "../assets/block/snow.png",             // 7
+        "../assets/block/red_sand.png",         // 8
+        "../assets/block/orange_terracotta.png",// 9
+        "../assets/block/gravel.png",           // 10
+        "../assets/block/podzol_top.png",       // 11
+        "../assets/block/podzol_side.png",      // 12
+        "../assets/block/oak_log.png",          // 13
+        "../assets/block/oak_log_top.png",      // 14
+        "../assets/block/oak_leaves.png",       // 15
+        "../assets/block/spruce_log.png",       // 16
+        "../assets/block/spruce_log_top.png",   // 17
+        "../assets/block/spruce_leaves.png"     // 18
     };
     unsigned int texArray = loadTextureArray(texturePaths);
 
     forceLoadInitialChunks();
 
+    char occlusionInfo[96] = "";
     while (!glfwWindowShouldClose(window)) {
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        updateChunks();
         processInput(window);
         camera.UpdatePhysics(deltaTime, worldChunks);
 
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        camera.updateFrustum((float)width / (float)height, glm::radians(45.0f), 0.1f, 500.0f);
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 500.0f);
+        glm::mat4 view = camera.GetViewMatrix();
+
+        // Il culler lavora sulla camera di questo frame mentre il thread principale aggiorna il mondo
+        startOcclusionCulling(projection * view);
+        updateChunks();
+        applyDeferredEdits();
+
         // Aggiorna titolo con blocco selezionato e FPS
+        // Telemetria del budget del thread principale: ultimo frame, lavoro rinviato, frame fuori budget
+        char budgetInfo[96];
+        std::snprintf(budgetInfo, sizeof(budgetInfo), " | Main: %.2f/%.1f ms, rinviati %zu, sforati %zu",
+                      mainThreadBudget.lastFrameMs(), mainThreadBudget.budget(),
+                      mainThreadBudget.lastFrameDeferred(), mainThreadBudget.overrunFrames());
+        // Profondità delle code dei due executor (task in attesa di un worker)
+        std::string queueInfo = " | Coda IO: " + std::to_string(ioThreadPool.pendingCount())
+                              + ", CPU: " + std::to_string(computeThreadPool.pendingCount());
+        // Occupazione dell'arena delle mesh (vertici), frammentazione dello spazio libero,
+        // reupload riscritti nel proprio intervallo / riallocati
+        ChunkMeshArena::Stats arenaStats = chunkMeshes.stats();
+        char arenaInfo[128];
+        std::snprintf(arenaInfo, sizeof(arenaInfo), " | Mesh: %zu/%zu k vertici, %zu blocchi liberi, framm. %.0f%%, reupload %zu/%zu",
+                      arenaStats.vertexUsed / 1000, arenaStats.vertexCapacity / 1000,
+                      arenaStats.freeBlocks, arenaStats.fragmentation * 100.0f,
+                      arenaStats.inPlaceUpdates, arenaStats.reallocations);
+        // Frammenti dei chunk (invocazioni del fragment shader o campioni passati, vedi FragmentCounter)
+        char fragmentInfo[64];
+        std::snprintf(fragmentInfo, sizeof(fragmentInfo), " | Frammenti: %.2f M (%s)",
+                      static_cast<double>(fragmentCounter.lastCount()) / 1e6,
+                      chunkDrawOrder.isSorted() ? "vicini prima" : "non ordinati");
         std::string title = "Minecraft Engine - alfanowski | Block: " + std::string(blockNames[selectedBlockIndex])
-                          + " | FPS: " + std::to_string(static_cast<int>(1.0f / deltaTime));
+                          + " | FPS: " + std::to_string(static_cast<int>(1.0f / deltaTime)) + budgetInfo + queueInfo + arenaInfo
+                          + fragmentInfo + occlusionInfo;
         glfwSetWindowTitle(window, title.c_str());
 
         glClearColor(0.52f, 0.80f, 0.92f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        ourShader.use();
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-
-        camera.updateFrustum((float)width / (float)height, glm::radians(45.0f), 0.1f, 500.0f);
-
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 500.0f);
-        ourShader.setMat4("projection", projection);
-        ourShader.setMat4("view", camera.GetViewMatrix());
+        chunkShader.use();
+        updateCameraUniforms(projection, view);
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D_ARRAY, texArray);
-        ourShader.setInt("textureArray", 0);
-
-        for (const auto& pair : worldChunks) {
-            const auto& chunk = pair.second;
-
-            if (chunk->isUploaded) {
-                glm::vec3 min = chunk->getMin();
-                glm::vec3 max = chunk->getMax();
-                if (camera.frustum.isBoxVisible(min, max)) {
-                    glm::mat4 model = glm::mat4(1.0f);
-                    model = glm::translate(model, glm::vec3(chunk->chunkX * 16, 0, chunk->chunkZ * 16));
-                    ourShader.setMat4("model", model);
-                    chunk->render();
-                }
+
+        chunkMeshes.bind(); // Un solo VAO per tutti i chunk
+        chunkDraws.clear();
+        fragmentCounter.begin();
+        // Chunk nel frustum già in ordine di distanza; salta quelli nascosti dal depth buffer software
+        const std::vector<unsigned char>& visible = occlusionCuller.wait();
+        for (size_t i = 0; i < cullKeys.size(); i++) {
+            if (!visible[i]) continue;
+            auto it = worldChunks.find(cullKeys[i]);
+            if (it == worldChunks.end() || !it->second->isUploaded) continue; // Scaricato o svuotato nel frattempo
+            Chunk* chunk = it->second.get();
+            if (chunkDraws.isAvailable()) {
+                unsigned int firstQuad[3], quadCount[3];
+                int ranges = chunk->visibleFaceRanges(camera.Position, firstQuad, quadCount);
+                chunkDraws.add(chunk->meshAllocation(), firstQuad, quadCount, ranges, chunk->chunkX, chunk->chunkZ);
+                continue;
             }
+            ourShader.setIVec2(chunkOffsetLocation, chunk->chunkX * Chunk::SIZE, chunk->chunkZ * Chunk::SIZE);
+            chunk->render(camera.Position);
         }
+        chunkDraws.submit(); // I comandi indiretti restano nell'ordine della lista
+        fragmentCounter.end();
+
+        // Mostrato nel titolo del frame successivo (il culler è di nuovo fermo solo dopo wait)
+        std::snprintf(occlusionInfo, sizeof(occlusionInfo), " | Occlusi: %zu/%zu (%.2f ms), sezioni %zu",
+                      occlusionCuller.lastOccluded(), occlusionCuller.lastTested(), occlusionCuller.lastMs(),
+                      sectionVisibility.lastVisited());
 
         glDisable(GL_DEPTH_TEST);
         drawCrosshair();
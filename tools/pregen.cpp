@@ -0,0 +1,160 @@
+// Pre-generazione offline del mondo: genera e salva un'area di chunk usando tutti i core.
+// Usa lo stesso formato di Chunk::saveToFile, quindi il gioco carica i chunk senza rigenerarli.
+//
+// Uso: WorldPregen --radius N [--center X Z] [--shape square|circle] [--threads N] [--save DIR]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <unordered_set>
+#include <algorithm>
+#include "Chunk.hpp"
+#include "Decoration.hpp"
+#include "ThreadPool.hpp"
+
+struct PregenOptions {
+    int radius = 16;
+    int centerX = 0, centerZ = 0;
+    bool circle = false;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string saveDir = "../world_save";
+};
+
+static void printUsage() {
+    std::cerr << "Uso: WorldPregen --radius N [--center X Z] [--shape square|circle] [--threads N] [--save DIR]\n"
+              << "  Coordinate e raggio sono in chunk. I chunk già presenti vengono saltati (ripresa).\n";
+}
+
+static bool parseArgs(int argc, char** argv, PregenOptions& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (arg == "--radius" && (v = next())) opt.radius = std::atoi(v);
+        else if (arg == "--center" && i + 2 < argc) { opt.centerX = std::atoi(argv[++i]); opt.centerZ = std::atoi(argv[++i]); }
+        else if (arg == "--shape" && (v = next())) opt.circle = (std::string(v) == "circle");
+        else if (arg == "--threads" && (v = next())) opt.threads = static_cast<unsigned int>(std::max(1, std::atoi(v)));
+        else if (arg == "--save" && (v = next())) opt.saveDir = v;
+        else return false;
+    }
+    return opt.radius >= 0;
+}
+
+int main(int argc, char** argv) {
+    PregenOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 1;
+    }
+
+    // Area richiesta, ordinata dal centro verso l'esterno: una run interrotta lascia un'area compatta
+    struct Coord { int x, z; };
+    std::vector<Coord> area;
+    for (int x = -opt.radius; x <= opt.radius; x++) {
+        for (int z = -opt.radius; z <= opt.radius; z++) {
+            if (opt.circle && x * x + z * z > opt.radius * opt.radius) continue;
+            area.push_back({ opt.centerX + x, opt.centerZ + z });
+        }
+    }
+    std::sort(area.begin(), area.end(), [&](const Coord& a, const Coord& b) {
+        int da = (a.x - opt.centerX) * (a.x - opt.centerX) + (a.z - opt.centerZ) * (a.z - opt.centerZ);
+        int db = (b.x - opt.centerX) * (b.x - opt.centerX) + (b.z - opt.centerZ) * (b.z - opt.centerZ);
+        return da < db;
+    });
+
+    std::unordered_set<long long> areaKeys;
+    std::vector<Coord> todo, existing;
+    for (const Coord& c : area) {
+        areaKeys.insert(chunkHash(c.x, c.z));
+        if (std::filesystem::exists(Chunk::filePath(opt.saveDir, c.x, c.z))) existing.push_back(c);
+        else todo.push_back(c);
+    }
+
+    std::cout << "Pre-generazione " << area.size() << " chunk (" << (opt.circle ? "cerchio" : "quadrato")
+              << ", raggio " << opt.radius << ", centro " << opt.centerX << "," << opt.centerZ << ") in "
+              << opt.saveDir << " con " << opt.threads << " thread\n"
+              << "  già presenti: " << existing.size() << ", da generare: " << todo.size() << std::endl;
+
+    PendingBlockStore pending;
+    std::atomic<size_t> done{0};
+    std::atomic<size_t> failed{0};
+    // L'ultimo chunk sveglia il thread principale: il tempo finale non include l'attesa del ridisegno
+    std::mutex progressMutex;
+    std::condition_variable allDone;
+    const size_t total = todo.size();
+    auto start = std::chrono::steady_clock::now();
+    auto end = start;
+
+    {
+        ThreadPool pool(opt.threads);
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(existing.size() + todo.size());
+
+        // I chunk già salvati emettono solo le chiome che sconfinano nei chunk nuovi
+        for (const Coord& c : existing) {
+            tasks.push_back(pool.submit([c, &opt, &pending]() {
+                Chunk chunk(c.x, c.z);
+                if (chunk.loadFromFile(opt.saveDir))
+                    decorateChunk(chunk, pending, false);
+            }));
+        }
+
+        for (const Coord& c : todo) {
+            tasks.push_back(pool.submit([c, &opt, &pending, &done, &failed, &progressMutex, &allDone, total]() {
+                Chunk chunk(c.x, c.z);
+                chunk.generateTerrain();
+                decorateChunk(chunk, pending, true);
+                applyPendingBlocks(chunk, pending);
+                if (!chunk.saveToFile(opt.saveDir)) failed++;
+                if (done.fetch_add(1) + 1 == total) {
+                    // Lock vuoto: il thread principale è già in attesa o vedrà done == total
+                    { std::lock_guard<std::mutex> lock(progressMutex); }
+                    allDone.notify_one();
+                }
+            }));
+        }
+
+        // Avanzamento sul thread principale: ridisegno ogni 500 ms, o subito all'ultimo chunk
+        while (done.load() < total) {
+            {
+                std::unique_lock<std::mutex> lock(progressMutex);
+                allDone.wait_for(lock, std::chrono::milliseconds(500), [&]() { return done.load() >= total; });
+            }
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            size_t n = done.load();
+            std::printf("\r  [%zu/%zu] %5.1f%%  %.0f chunk/s", n, total, total ? 100.0 * n / total : 100.0, n / std::max(secs, 1e-6));
+            std::fflush(stdout);
+        }
+        for (auto& t : tasks) t.wait();
+        std::printf("\n");
+
+        // Chiome arrivate dopo il salvataggio del chunk di destinazione: ricarica, applica, risalva
+        std::vector<long long> lateKeys;
+        for (long long key : pending.keys())
+            if (areaKeys.count(key)) lateKeys.push_back(key);
+        tasks.clear();
+        for (long long key : lateKeys) {
+            int cx = static_cast<int>(key >> 32);
+            int cz = static_cast<int>(static_cast<unsigned int>(key));
+            tasks.push_back(pool.submit([cx, cz, &opt, &pending, &failed]() {
+                Chunk chunk(cx, cz);
+                if (!chunk.loadFromFile(opt.saveDir)) return;
+                if (applyPendingBlocks(chunk, pending) && !chunk.saveToFile(opt.saveDir)) failed++;
+            }));
+        }
+        for (auto& t : tasks) t.wait();
+        end = std::chrono::steady_clock::now(); // Fine delle chiome tardive, prima della chiusura del pool
+    }
+
+    double secs = std::chrono::duration<double>(end - start).count();
+    std::printf("Completato: %zu chunk in %.2f s (%.0f chunk/s), %zu errori di scrittura\n",
+                done.load(), secs, done.load() / std::max(secs, 1e-6), failed.load());
+    return failed.load() == 0 ? 0 : 2;
+}
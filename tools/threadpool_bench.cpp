@@ -0,0 +1,307 @@
+// Benchmark del thread pool: work-stealing (ThreadPool) contro la vecchia coda unica con lock.
+// Scenari:
+//   micro   - molti task minuscoli inviati dal thread principale (contesa sulla coda)
+//   nested  - task che ne lanciano altri dai worker (es. generazione -> meshing)
+//   chunks  - burst di 289 chunk (RENDER_DISTANCE 8): generateTerrain + mesh lanciato dal worker
+//   jobs    - job vuoti: submit (future) contro post (Task senza allocazioni), job/s e allocazioni per job
+//   cicli   - job di chunk veri (vuoti sul worker) lungo tutto il ciclo del gioco: ChunkScheduler::acquire,
+//             chiave in ChunkKeySet, slot() e dispatch, resumeOn, resumeOnMainThread + drain, release.
+//             Job/s e allocazioni per job a regime (dopo un giro di riscaldamento)
+//
+// Uso: ThreadPoolBench [--tasks N]
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include "ThreadPool.hpp"
+#include "Chunk.hpp"
+#include "ChunkScheduler.hpp"
+#include "ChunkTask.hpp"
+#include "ChunkKeySet.hpp"
+
+// Conta le allocazioni globali (sostituisce operator new/delete per tutto l'eseguibile)
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    // Implementazione precedente: un'unica std::queue protetta da un solo mutex
+    class LockedQueuePool {
+    public:
+        explicit LockedQueuePool(size_t numThreads) : stop(false) {
+            for (size_t i = 0; i < numThreads; i++) {
+                workers.emplace_back([this]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock(queueMutex);
+                            condition.wait(lock, [this]() { return stop || !tasks.empty(); });
+                            if (stop && tasks.empty()) return;
+                            task = std::move(tasks.front());
+                            tasks.pop();
+                        }
+                        task();
+                    }
+                });
+            }
+        }
+
+        ~LockedQueuePool() {
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                stop = true;
+            }
+            condition.notify_all();
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        template<typename F>
+        std::future<void> submit(F&& f) {
+            auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
+            std::future<void> result = task->get_future();
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                tasks.emplace([task]() { (*task)(); });
+            }
+            condition.notify_one();
+            return result;
+        }
+
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex queueMutex;
+        std::condition_variable condition;
+        bool stop;
+    };
+
+    void spinWork(int iterations) {
+        volatile unsigned int x = 0;
+        for (int i = 0; i < iterations; i++) x = x * 1664525u + 1013904223u;
+    }
+
+    void waitFor(const std::atomic<int>& counter, int target) {
+        while (counter.load(std::memory_order_acquire) < target)
+            std::this_thread::yield();
+    }
+
+    template<typename Pool>
+    double benchMicro(size_t threads, int tasks) {
+        Pool pool(threads);
+        std::atomic<int> done{0};
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < tasks; i++)
+            pool.submit([&done]() { spinWork(50); done.fetch_add(1, std::memory_order_release); });
+        waitFor(done, tasks);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return tasks / secs;
+    }
+
+    template<typename Pool>
+    double benchNested(size_t threads, int parents) {
+        const int CHILDREN = 16;
+        Pool pool(threads);
+        std::atomic<int> done{0};
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < parents; i++) {
+            pool.submit([&pool, &done]() {
+                spinWork(200);
+                for (int c = 0; c < CHILDREN; c++)
+                    pool.submit([&done]() { spinWork(200); done.fetch_add(1, std::memory_order_release); });
+                done.fetch_add(1, std::memory_order_release);
+            });
+        }
+        waitFor(done, parents * (CHILDREN + 1));
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return parents * (CHILDREN + 1) / secs;
+    }
+
+    struct JobsResult {
+        double jobsPerSec;
+        double allocationsPerJob;
+    };
+
+    // Job vuoti con submit (usePost = false) o post: misura anche le allocazioni per job
+    JobsResult benchJobs(size_t threads, int tasks, bool usePost) {
+        ThreadPool pool(threads);
+        std::atomic<int> done{0};
+        auto job = [&done]() { done.fetch_add(1, std::memory_order_release); };
+        // Riscaldamento: le deque dei worker raggiungono la capacità di regime
+        for (int i = 0; i < tasks; i++) pool.post(job);
+        waitFor(done, tasks);
+        done.store(0);
+
+        size_t allocsBefore = allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < tasks; i++) {
+            if (usePost) pool.post(job);
+            else pool.submit(job);
+        }
+        waitFor(done, tasks);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t allocs = allocationCount.load() - allocsBefore;
+        return { tasks / secs, static_cast<double>(allocs) / tasks };
+    }
+
+    // Stato del "thread principale" per lo scenario cicli: stessi pezzi di main.cpp
+    struct CycleContext {
+        ThreadPool pool;
+        ChunkScheduler scheduler;
+        CompletionQueue mainThreadQueue;
+        ChunkKeySet queuedKeys;
+        size_t jobsInFlight = 0;
+        size_t completed = 0;
+
+        explicit CycleContext(size_t threads) : pool(threads) {}
+    };
+
+    // Stessa forma di generateChunk in main.cpp, senza lavoro sul worker
+    ChunkTask cycleJob(CycleContext& ctx, std::shared_ptr<Chunk> chunk) {
+        ChunkJob* job = ctx.scheduler.acquire();
+        job->kind = ChunkJobKind::GENERATE;
+        job->chunkX = chunk->chunkX;
+        job->chunkZ = chunk->chunkZ;
+        job->key = chunkHash(chunk->chunkX, chunk->chunkZ);
+        job->chunks.push_back(std::move(chunk));
+        ctx.queuedKeys.insert(job->key);
+
+        if (co_await ctx.scheduler.slot(job)) {
+            co_await resumeOn(ctx.pool);
+            co_await resumeOnMainThread(ctx.mainThreadQueue);
+            ctx.jobsInFlight--;
+        }
+        ctx.queuedKeys.erase(job->key);
+        ctx.scheduler.release(job);
+        ctx.completed++;
+    }
+
+    // Un'ondata per ogni chunk di `chunks`, con dispatch a slot e drain come nel ciclo del gioco
+    void runCycleWaves(CycleContext& ctx, const std::vector<std::shared_ptr<Chunk>>& chunks, int jobs) {
+        size_t maxInFlight = ctx.pool.size() * 2;
+        ctx.completed = 0;
+        for (int launched = 0; launched < jobs; ) {
+            size_t wave = std::min(chunks.size(), static_cast<size_t>(jobs - launched));
+            size_t target = ctx.completed + wave;
+            for (size_t i = 0; i < wave; i++) cycleJob(ctx, chunks[i]);
+            launched += static_cast<int>(wave);
+
+            while (ctx.completed < target) {
+                size_t slots = ctx.jobsInFlight < maxInFlight ? maxInFlight - ctx.jobsInFlight : 0;
+                for (ChunkJob* job : ctx.scheduler.takeReady(slots)) {
+                    ctx.jobsInFlight++;
+                    job->waiter.resume();
+                }
+                CompletionNode* node = ctx.mainThreadQueue.pop();
+                if (node) resumeCompleted(node);
+                else std::this_thread::yield();
+            }
+        }
+    }
+
+    JobsResult benchCycles(size_t threads, int jobs) {
+        // Chunk distinti in un'ondata: chiavi diverse in queuedKeys, come i chunk di un anello
+        const int R = WorldConfig::RENDER_DISTANCE;
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        for (int x = -R; x <= R; x++)
+            for (int z = -R; z <= R; z++)
+                chunks.push_back(std::make_shared<Chunk>(x, z));
+
+        CycleContext ctx(threads);
+        // Riscaldamento: record dello scheduler, frame delle coroutine, heap e deque alla capacità di regime
+        runCycleWaves(ctx, chunks, static_cast<int>(chunks.size()));
+
+        size_t allocsBefore = allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+        runCycleWaves(ctx, chunks, jobs);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t allocs = allocationCount.load() - allocsBefore;
+        return { jobs / secs, static_cast<double>(allocs) / jobs };
+    }
+
+    template<typename Pool>
+    double benchChunks(size_t threads) {
+        const int R = WorldConfig::RENDER_DISTANCE;
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        for (int x = -R; x <= R; x++)
+            for (int z = -R; z <= R; z++)
+                chunks.push_back(std::make_unique<Chunk>(x, z));
+
+        Pool pool(threads);
+        std::atomic<int> done{0};
+        auto start = std::chrono::steady_clock::now();
+        for (auto& chunk : chunks) {
+            Chunk* c = chunk.get();
+            pool.submit([&pool, &done, c]() {
+                c->generateTerrain();
+                pool.submit([&done, c]() { c->rebuildMeshOnly(); done.fetch_add(1, std::memory_order_release); });
+            });
+        }
+        waitFor(done, static_cast<int>(chunks.size()));
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return chunks.size() / secs;
+    }
+}
+
+int main(int argc, char** argv) {
+    int tasks = 200000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tasks" && i + 1 < argc) tasks = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "Uso: ThreadPoolBench [--tasks N]" << std::endl;
+            return 1;
+        }
+    }
+
+    const size_t threadCounts[] = { 2, 4, 8, 16, 32 };
+    std::printf("%-8s %-8s %14s %14s %8s\n", "scenario", "thread", "coda unica", "work-stealing", "x");
+    for (size_t threads : threadCounts) {
+        double a = benchMicro<LockedQueuePool>(threads, tasks);
+        double b = benchMicro<ThreadPool>(threads, tasks);
+        std::printf("%-8s %-8zu %10.0f t/s %10.0f t/s %7.2fx\n", "micro", threads, a, b, b / a);
+    }
+    for (size_t threads : threadCounts) {
+        double a = benchNested<LockedQueuePool>(threads, tasks / 17);
+        double b = benchNested<ThreadPool>(threads, tasks / 17);
+        std::printf("%-8s %-8zu %10.0f t/s %10.0f t/s %7.2fx\n", "nested", threads, a, b, b / a);
+    }
+    for (size_t threads : threadCounts) {
+        double a = benchChunks<LockedQueuePool>(threads);
+        double b = benchChunks<ThreadPool>(threads);
+        std::printf("%-8s %-8zu %10.0f c/s %10.0f c/s %7.2fx\n", "chunks", threads, a, b, b / a);
+    }
+
+    std::printf("\n%-8s %-8s %14s %10s %14s %10s\n", "scenario", "thread", "submit", "alloc/job", "post", "alloc/job");
+    for (size_t threads : threadCounts) {
+        JobsResult a = benchJobs(threads, tasks, false);
+        JobsResult b = benchJobs(threads, tasks, true);
+        std::printf("%-8s %-8zu %10.0f j/s %10.2f %10.0f j/s %10.2f\n", "jobs", threads,
+                    a.jobsPerSec, a.allocationsPerJob, b.jobsPerSec, b.allocationsPerJob);
+    }
+
+    std::printf("\n%-8s %-8s %14s %10s\n", "scenario", "thread", "ciclo chunk", "alloc/job");
+    for (size_t threads : threadCounts) {
+        JobsResult r = benchCycles(threads, tasks);
+        std::printf("%-8s %-8zu %10.0f j/s %10.2f\n", "cicli", threads, r.jobsPerSec, r.allocationsPerJob);
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Regressione deterministica della generazione del mondo + misura del throughput.
+// Genera una griglia fissa di chunk (terreno, biomi, decorazioni) per un insieme di seed,
+// confronta l'hash dei blocchi di ogni chunk con i valori golden e riporta i tempi per chunk.
+//
+// Uso: WorldGenCheck [--golden FILE] [--update] [--repeat N] [--budget-us N]
+//   --update     riscrive il file golden con gli hash correnti
+//   --repeat N   ripete la sola generazione N volte per stabilizzare i tempi
+//   --budget-us  fallisce se il tempo medio di generazione per chunk supera il budget
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include "Chunk.hpp"
+#include "Biome.hpp"
+#include "Decoration.hpp"
+
+namespace {
+    const int SEEDS[] = { WorldConfig::WORLD_SEED, 42, 20240521 };
+    const int GRID_MIN = -4;
+    const int GRID_MAX = 3; // Griglia 8x8 attorno all'origine
+
+    // FNV-1a a 64 bit in ordine canonico x,y,z: indipendente dal layout in memoria di Chunk::blocks
+    uint64_t hashBlocks(const Chunk& chunk) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (int x = 0; x < Chunk::SIZE; x++)
+            for (int y = 0; y < Chunk::HEIGHT; y++)
+                for (int z = 0; z < Chunk::SIZE; z++) {
+                    h ^= chunk.getBlock(x, y, z);
+                    h *= 0x100000001b3ull;
+                }
+        return h;
+    }
+
+    struct Timings {
+        std::vector<double> samples; // microsecondi
+
+        void add(double us) { samples.push_back(us); }
+
+        void print(const char* label) {
+            if (samples.empty()) return;
+            std::sort(samples.begin(), samples.end());
+            double sum = 0;
+            for (double s : samples) sum += s;
+            double mean = sum / samples.size();
+            double p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+            std::printf("  %-14s mean %8.1f us  min %8.1f  p95 %8.1f  max %8.1f  (%.0f chunk/s)\n",
+                        label, mean, samples.front(), p95, samples.back(), 1e6 / mean);
+        }
+
+        double mean() const {
+            double sum = 0;
+            for (double s : samples) sum += s;
+            return samples.empty() ? 0.0 : sum / samples.size();
+        }
+    };
+
+    double elapsedUs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string goldenKey(int seed, int cx, int cz) {
+        return std::to_string(seed) + " " + std::to_string(cx) + " " + std::to_string(cz);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string goldenPath = "../tools/worldgen_golden.txt";
+    bool update = false;
+    int repeat = 1;
+    double budgetUs = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--golden" && i + 1 < argc) goldenPath = argv[++i];
+        else if (arg == "--update") update = true;
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--budget-us" && i + 1 < argc) budgetUs = std::atof(argv[++i]);
+        else {
+            std::cerr << "Uso: WorldGenCheck [--golden FILE] [--update] [--repeat N] [--budget-us N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Valori golden: una riga "seed cx cz hash" per chunk
+    std::map<std::string, uint64_t> golden;
+    if (!update) {
+        std::ifstream in(goldenPath);
+        if (!in.is_open()) {
+            std::cerr << "ERRORE: file golden non trovato: " << goldenPath << " (usa --update per crearlo)" << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream ss(line);
+            int seed, cx, cz;
+            std::string hex;
+            if (ss >> seed >> cx >> cz >> hex)
+                golden[goldenKey(seed, cx, cz)] = std::stoull(hex, nullptr, 16);
+        }
+    }
+
+    Timings biomeTime, terrainTime, decorationTime;
+    std::ostringstream updated;
+    updated << "# seed chunkX chunkZ hash (FNV-1a 64 dei blocchi in ordine x,y,z) - generato da WorldGenCheck --update\n";
+    int mismatches = 0, missing = 0, checked = 0;
+
+    for (int seed : SEEDS) {
+        std::map<long long, std::unique_ptr<Chunk>> chunks;
+        PendingBlockStore pending;
+
+        // Misura del solo campionamento biomi (budget fisso per chunk)
+        BiomeMap biomeMap(seed);
+        for (int cx = GRID_MIN; cx <= GRID_MAX; cx++) {
+            for (int cz = GRID_MIN; cz <= GRID_MAX; cz++) {
+                ColumnBiome columns[Chunk::SIZE][Chunk::SIZE];
+                auto start = std::chrono::steady_clock::now();
+                biomeMap.sampleChunk(cx, cz, columns);
+                biomeTime.add(elapsedUs(start));
+            }
+        }
+
+        for (int r = 0; r < repeat; r++) {
+            for (int cx = GRID_MIN; cx <= GRID_MAX; cx++) {
+                for (int cz = GRID_MIN; cz <= GRID_MAX; cz++) {
+                    auto chunk = std::make_unique<Chunk>(cx, cz);
+                    auto start = std::chrono::steady_clock::now();
+                    chunk->generateTerrain(seed);
+                    terrainTime.add(elapsedUs(start));
+                    if (r == repeat - 1) chunks[chunkHash(cx, cz)] = std::move(chunk);
+                }
+            }
+        }
+
+        // Decorazioni in ordine fisso, poi le scritture pendenti tra chunk della griglia
+        for (int cx = GRID_MIN; cx <= GRID_MAX; cx++) {
+            for (int cz = GRID_MIN; cz <= GRID_MAX; cz++) {
+                Chunk& chunk = *chunks[chunkHash(cx, cz)];
+                auto start = std::chrono::steady_clock::now();
+                decorateChunk(chunk, pending, true, NO_TARGET, seed);
+                decorationTime.add(elapsedUs(start));
+            }
+        }
+        for (auto& entry : chunks)
+            applyPendingBlocks(*entry.second, pending);
+
+        for (int cx = GRID_MIN; cx <= GRID_MAX; cx++) {
+            for (int cz = GRID_MIN; cz <= GRID_MAX; cz++) {
+                uint64_t h = hashBlocks(*chunks[chunkHash(cx, cz)]);
+                char hex[17];
+                std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+                updated << seed << " " << cx << " " << cz << " " << hex << "\n";
+                if (update) continue;
+
+                checked++;
+                auto it = golden.find(goldenKey(seed, cx, cz));
+                if (it == golden.end()) {
+                    missing++;
+                } else if (it->second != h) {
+                    mismatches++;
+                    if (mismatches <= 10)
+                        std::printf("  DIVERSO seed %d chunk (%d,%d): atteso %016llx, ottenuto %s\n",
+                                    seed, cx, cz, static_cast<unsigned long long>(it->second), hex);
+                }
+            }
+        }
+    }
+
+    std::printf("Generazione (%zu seed, griglia %dx%d, %d campioni bioma per chunk):\n",
+                std::size(SEEDS), GRID_MAX - GRID_MIN + 1, GRID_MAX - GRID_MIN + 1, WorldConfig::BIOME_SAMPLES_PER_CHUNK);
+    biomeTime.print("biomi");
+    terrainTime.print("terreno");
+    decorationTime.print("decorazioni");
+
+    if (update) {
+        std::ofstream out(goldenPath);
+        out << updated.str();
+        std::printf("Golden aggiornati in %s\n", goldenPath.c_str());
+        return out.good() ? 0 : 1;
+    }
+
+    std::printf("Hash: %d chunk controllati, %d diversi, %d mancanti\n", checked, mismatches, missing);
+    bool overBudget = budgetUs > 0.0 && terrainTime.mean() > budgetUs;
+    if (overBudget)
+        std::printf("FUORI BUDGET: %.1f us medi per chunk (budget %.1f us)\n", terrainTime.mean(), budgetUs);
+    return (mismatches == 0 && missing == 0 && !overBudget) ? 0 : 1;
+}